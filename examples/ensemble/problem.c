@@ -0,0 +1,68 @@
+/**
+ * Ensembles
+ *
+ * This example integrates many copies of a simulation that share the same REBOUNDx effects,
+ * sweeping the orbital damping timescale of modify_orbits_forces across members.
+ * Members run in parallel on all cores (the Makefile compiles with OpenMP), and the final
+ * semimajor axis and eccentricity of each member are gathered into one array.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "rebound.h"
+#include "reboundx.h"
+
+// Called on each member after it is integrated
+void record(struct reb_simulation* const sim, struct rebx_extras* const rebx, const int member, double* const results, void* ref){
+    struct reb_orbit o = reb_orbit_from_particle(sim->G, sim->particles[1], sim->particles[0]);
+    results[0] = o.a;
+    results[1] = o.e;
+}
+
+int main(int argc, char* argv[]){
+    struct reb_simulation* sim = reb_simulation_create();
+    sim->dt = 0.05;
+
+    struct reb_particle star = {0};
+    star.m = 1.;
+    reb_simulation_add(sim, star);
+    struct reb_particle planet = reb_particle_from_orbit(sim->G, star, 1.e-4, 1., 0.1, 0., 0., 0., 0.);
+    reb_simulation_add(sim, planet);
+    reb_simulation_move_to_com(sim);
+
+    // The template. Every member gets a copy of these effects and parameters
+    struct rebx_extras* rebx = rebx_attach(sim);
+    struct rebx_force* mof = rebx_load_force(rebx, "modify_orbits_forces");
+    rebx_add_force(rebx, mof);
+    rebx_set_param_double(rebx, &sim->particles[1].ap, "tau_a", -1.e4);
+    rebx_set_param_double(rebx, &sim->particles[1].ap, "tau_e", -1.e3);
+
+    // One column of the override table: tau_e on particle 1 changes from member to member
+    const int N_members = 64;
+    double* tau_e = malloc(N_members*sizeof(double));
+    for (int i=0; i<N_members; i++){
+        tau_e[i] = -1.e2*pow(10., 3.*i/(N_members-1));
+    }
+    struct rebx_ensemble_param params[1] = {{.name = "tau_e", .effect = NULL, .index = 1, .values = tau_e}};
+
+    double* results = malloc(2*N_members*sizeof(double));
+    struct rebx_ensemble ensemble = {
+        .N_members = N_members,
+        .tmax = 1.e3,
+        .N_params = 1,
+        .params = params,
+        .record = record,
+        .N_results = 2,
+        .results = results,
+    };
+    rebx_integrate_ensemble(rebx, &ensemble);
+
+    for (int i=0; i<N_members; i++){
+        printf("tau_e = %e\ta = %f\te = %e\n", tau_e[i], results[2*i], results[2*i+1]);
+    }
+
+    free(results);
+    free(tau_e);
+    rebx_free(rebx);    // Free all the memory allocated by rebx
+    reb_simulation_free(sim);
+}
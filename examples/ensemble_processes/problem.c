@@ -0,0 +1,64 @@
+/**
+ * Ensembles in worker processes
+ *
+ * This example sweeps the orbital damping timescale of modify_orbits_forces across many copies
+ * of a simulation like the ensemble example, but integrates the members in separate worker processes.
+ * Workers write each member's final orbits, min_distance and spin parameters and energy error into
+ * fixed-size records of one memory-mapped result file, which we read back at the end.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "rebound.h"
+#include "reboundx.h"
+
+int main(int argc, char* argv[]){
+    struct reb_simulation* sim = reb_simulation_create();
+    sim->dt = 0.05;
+
+    struct reb_particle star = {0};
+    star.m = 1.;
+    reb_simulation_add(sim, star);
+    struct reb_particle planet = reb_particle_from_orbit(sim->G, star, 1.e-4, 1., 0.1, 0., 0., 0., 0.);
+    reb_simulation_add(sim, planet);
+    reb_simulation_move_to_com(sim);
+
+    // The template. Workers load these effects and parameters from a REBOUNDx binary stored in the result file
+    struct rebx_extras* rebx = rebx_attach(sim);
+    struct rebx_force* mof = rebx_load_force(rebx, "modify_orbits_forces");
+    rebx_add_force(rebx, mof);
+    rebx_set_param_double(rebx, &sim->particles[1].ap, "tau_a", -1.e4);
+    rebx_set_param_double(rebx, &sim->particles[1].ap, "tau_e", -1.e3);
+
+    const int N_members = 64;
+    double* tau_e = malloc(N_members*sizeof(double));
+    for (int i=0; i<N_members; i++){
+        tau_e[i] = -1.e2*pow(10., 3.*i/(N_members-1));
+    }
+    struct rebx_ensemble_param params[1] = {{.name = "tau_e", .effect = NULL, .index = 1, .values = tau_e}};
+    struct rebx_ensemble ensemble = {
+        .N_members = N_members,
+        .tmax = 1.e3,
+        .N_params = 1,
+        .params = params,
+    };
+    rebx_integrate_ensemble_processes(rebx, &ensemble, "results.bin", 0); // one worker per processor
+
+    // The result file can be mapped or read by any program. Here we read it into memory
+    FILE* f = fopen("results.bin", "rb");
+    fseek(f, 0, SEEK_END);
+    const long size = ftell(f);
+    rewind(f);
+    struct rebx_ensemble_file_header* header = malloc(size);
+    fread(header, 1, size, f);
+    fclose(f);
+    for (int i=0; i<N_members; i++){
+        struct rebx_ensemble_member_record* record = rebx_ensemble_file_member(header, i);
+        printf("tau_e = %e\ta = %f\te = %e\tenergy error = %e\n", tau_e[i], record->particles[1].a, record->particles[1].e, record->energy_error);
+    }
+
+    free(header);
+    free(tau_e);
+    rebx_free(rebx);    // Free all the memory allocated by rebx
+    reb_simulation_free(sim);
+}
@@ -1,14 +1,16 @@
 from . import clibreboundx
-from ctypes import Structure, c_double, POINTER, c_int, c_uint, c_long, c_ulong, c_void_p, c_char_p, CFUNCTYPE, byref, c_uint32, c_uint, cast, c_char, pointer
+from ctypes import Structure, c_double, POINTER, c_int, c_uint, c_long, c_ulong, c_void_p, c_char_p, CFUNCTYPE, byref, c_uint32, c_uint, cast, c_char, pointer, c_size_t, string_at
 import rebound
 import reboundx
 import warnings
+import weakref
 
 integrators = {"implicit_midpoint": 0, "rk4":1, "euler": 2, "rk2": 3, "none": -1}
 
 REBX_TIMING = {"pre":-1, "post":1}
 REBX_FORCE_TYPE = {"none":0, "pos":1, "vel":2}
 REBX_OPERATOR_TYPE = {"none":0, "updater":1, "recorder":2}
+REBX_EFFECT_CAPABILITIES = {"force":1, "operator":2, "velocity_dependent":4, "recorder":8, "modifies_params":16, "random":32, "has_energy":64, "uses_gravity":128}
 
 REBX_BINARY_WARNINGS = [
     (True, 1, "REBOUNDx: Cannot open binary file. Check filename."),
@@ -28,6 +30,25 @@ REBX_BINARY_WARNINGS = [
     (False,16384, "REBOUNDx: Binary file was saved with a different version of REBOUNDx. Binary format might have changed. Check that effects and parameters are loaded as expected.")
 ]
 
+def _process_binary_warnings(w):
+    for majorerror, value, message in REBX_BINARY_WARNINGS:
+        if w.value & value:
+            if majorerror:
+                raise RuntimeError(message)
+            else:
+                warnings.warn(message, RuntimeWarning)
+
+def _extras_from_bytes(sim, data):
+    """
+    Recreates an Extras instance pickled with Extras.__reduce__, attached to sim.
+    """
+    rebx = Extras(sim)
+    w = c_int(0)
+    clibreboundx.rebx_init_extras_from_buffer(byref(rebx), c_char_p(data), c_size_t(len(data)), byref(w))
+    _process_binary_warnings(w)
+    rebx.process_messages()
+    return rebx
+
 class Extras(Structure):
     """
     Main object used for all REBOUNDx operations, tied to a particular REBOUND simulation.
@@ -42,23 +63,31 @@ class Extras(Structure):
 
     def __init__(self, sim, filename=None):
         sim._extras_ref = self # add a reference to this instance in sim to make sure it's not garbage collected_
-        clibreboundx.rebx_initialize(byref(sim), byref(self))
-        # Create simulation
-        if filename==None:
-            # Create a new rebx instance
-           clibreboundx.rebx_register_default_params(byref(self))
-        else:
+        self._simref = weakref.ref(sim) # the Python simulation object, needed for pickling
+        clibreboundx.rebx_initialize(byref(sim), byref(self)) # default params are always registered
+        if filename is not None:
             # Recreate existing simulation.
             # Load registered parameters from binary
             w = c_int(0)
             clibreboundx.rebx_init_extras_from_binary(byref(self), c_char_p(filename.encode('ascii')), byref(w))
-            for majorerror, value, message in REBX_BINARY_WARNINGS:
-                if w.value & value:
-                    if majorerror:
-                        raise RuntimeError(message)
-                    else:
-                        warnings.warn(message, RuntimeWarning)
+            _process_binary_warnings(w)
+        self.process_messages()
+
+    def __reduce__(self):
+        """
+        Pickles the REBOUNDx instance through an in-memory binary, together with the simulation it is attached to.
+        Like binaries, custom forces and operators written in Python are not saved.
+        """
+        sim = self._simref() if hasattr(self, "_simref") else None
+        if sim is None:
+            raise RuntimeError("REBOUNDx Error: Can only pickle Extras instances attached to a live simulation.")
+        buf = POINTER(c_char)()
+        size = c_size_t()
+        clibreboundx.rebx_output_binary_to_buffer(byref(self), byref(buf), byref(size))
         self.process_messages()
+        data = string_at(buf, size.value)
+        clibreboundx.rebx_output_free_buffer(buf)
+        return (_extras_from_bytes, (sim, data))
 
     def __del__(self):
         if self._b_needsfree_ == 1:
@@ -68,6 +97,17 @@ class Extras(Structure):
         sim._extras_ref = None # remove reference to rebx so it can be garbage collected
         clibreboundx.rebx_detach(byref(sim), byref(self))
 
+    def copy(self, sim):
+        """
+        Attaches a copy of this REBOUNDx instance to sim, typically a copy of the simulation made with sim.copy(), and returns it.
+        All forces, operators and parameters are deep copied, while parameters bound to interpolators share their interpolation tables with the original.
+        Custom forces and operators written in Python call the same Python functions as the original, so keep the original's effects alive while using the copy.
+        """
+        rebx = Extras(sim)
+        clibreboundx.rebx_copy_extras(byref(rebx), byref(self))
+        rebx.process_messages()
+        return rebx
+
     #######################################
     # Functions for manipulating REBOUNDx effects
     #######################################
@@ -95,6 +135,22 @@ class Extras(Structure):
         self.process_messages()
         return ptr.contents
 
+    @property
+    def particle_params(self):
+        """
+        Vectorized access to double parameters on all particles through numpy arrays. See ParticleParams.
+        """
+        from .params import ParticleParams
+        return ParticleParams(self)
+
+    def effect_capabilities(self, name):
+        """
+        Returns the set of capabilities (keys of REBX_EFFECT_CAPABILITIES) of the built-in force or operator name. Empty if there is no such effect.
+        """
+        clibreboundx.rebx_get_effect_capabilities.restype = c_uint
+        flags = clibreboundx.rebx_get_effect_capabilities(c_char_p(name.encode('ascii')))
+        return {cap for cap, value in REBX_EFFECT_CAPABILITIES.items() if flags & value}
+
     def create_operator(self, name):
         clibreboundx.rebx_create_operator.restype = POINTER(Operator)
         ptr = clibreboundx.rebx_create_operator(byref(self), c_char_p(name.encode('ascii')))
@@ -148,6 +204,40 @@ class Extras(Structure):
         if not success:
             raise AttributeError("REBOUNDx Error: Operator {0} passed to rebx.remove_operator not found in simulation.")
 
+    #######################################
+    # Ensembles
+    #######################################
+    def integrate_ensemble(self, tmax, N_members, params=None, N_threads=0):
+        """
+        Integrates N_members independent copies of the simulation and its REBOUNDx effects to tmax, in parallel when REBOUNDx is compiled with OpenMP. The simulation itself is not modified.
+
+        params is a list of (name, target, values) tuples, each overriding a double parameter with one value per member. target is either a particle index or the name of a loaded force or operator.
+        Returns a numpy array of shape (N_members, N, 6) with the final x, y, z, vx, vy, vz of every particle in each member, and a numpy array with the status each member's integration ended with.
+        """
+        import numpy as np
+        params = [] if params is None else params
+        cparams = (EnsembleParam*len(params))()
+        values_arrays = [] # must stay alive during the C call
+        for cparam, (name, target, values) in zip(cparams, params):
+            values = np.ascontiguousarray(values, dtype=np.float64)
+            if values.shape != (N_members,):
+                raise ValueError("REBOUNDx Error: Need one value per member for ensemble parameter '{0}'.".format(name))
+            values_arrays.append(values)
+            cparam.name = name.encode('ascii')
+            if isinstance(target, str):
+                cparam.effect = target.encode('ascii')
+            else:
+                cparam.index = target
+            cparam.values = values.ctypes.data_as(POINTER(c_double))
+
+        N = self._sim.contents.N
+        results = np.empty((N_members, N, 6), dtype=np.float64)
+        status = np.empty(N_members, dtype=np.intc)
+        ensemble = Ensemble(N_members=N_members, tmax=tmax, N_params=len(params), params=cparams, N_results=6*N, results=results.ctypes.data_as(POINTER(c_double)), status=status.ctypes.data_as(POINTER(c_int)), N_threads=N_threads)
+        clibreboundx.rebx_integrate_ensemble(byref(self), byref(ensemble))
+        self.process_messages()
+        return results, status
+
     #######################################
     # Input/Output Routines
     #######################################
@@ -253,7 +343,10 @@ class Param(Structure): # need to define fields afterward because of circular re
     pass
 Param._fields_ =  [ ("name", c_char_p),
                     ("type", c_int),
-                    ("value", c_void_p)]
+                    ("_pooled", c_int),
+                    ("value", c_void_p),
+                    ("key", c_int),
+                    ("length", c_int)]
 
 class Node(Structure): # need to define fields afterward because of circular ref in linked list
     pass
@@ -322,7 +415,11 @@ Force._fields_ = [  ("name", c_char_p),
                     ("ap", POINTER(Node)),
                     ("_sim", POINTER(rebound.Simulation)),
                     ("_force_type", c_int),
-                    ("_update_accelerations", FORCEFUNCPTR)]
+                    ("_update_accelerations", FORCEFUNCPTR),
+                    ("_participants", c_void_p),
+                    ("_acc_buffers", c_void_p),
+                    ("_workspace", c_void_p),
+                    ("_workspace_size", c_size_t)]
 
 # Need to put fields after class definition because of self-referencing
 Extras._fields_ =  [("_sim", POINTER(rebound.Simulation)),
@@ -331,7 +428,40 @@ Extras._fields_ =  [("_sim", POINTER(rebound.Simulation)),
                     ("_post_timestep_modifications", POINTER(Node)),
                     ("_registered_params", POINTER(Node)),
                     ("_allocated_forces", POINTER(Node)),
-                    ("_allocated_operators", POINTER(Node))]
+                    ("_allocated_operators", POINTER(Node)),
+                    ("_param_keys", POINTER(POINTER(Param))),
+                    ("_N_param_keys", c_int),
+                    ("_N_allocated_param_keys", c_int),
+                    ("_param_generation", c_ulong),
+                    ("_pool", c_void_p),
+                    ("_param_index", POINTER(c_int)),
+                    ("_N_allocated_param_index", c_int),
+                    ("_plan", c_void_p),
+                    ("_interpolated_params", c_void_p),
+                    ("_N_interpolated_params", c_int),
+                    ("_N_allocated_interpolated_params", c_int),
+                    ("_interpolated_params_t", c_double),
+                    ("parallel_forces", c_int),
+                    ("deterministic_reductions", c_int)]
+
+class EnsembleParam(Structure):
+    _fields_ = [("name", c_char_p),
+                ("effect", c_char_p),
+                ("index", c_int),
+                ("values", POINTER(c_double))]
+
+class Ensemble(Structure):
+    _fields_ = [("N_members", c_int),
+                ("tmax", c_double),
+                ("N_params", c_int),
+                ("params", POINTER(EnsembleParam)),
+                ("_setup", c_void_p),
+                ("_record", c_void_p),
+                ("N_results", c_int),
+                ("results", POINTER(c_double)),
+                ("status", POINTER(c_int)),
+                ("N_threads", c_int),
+                ("_ref", c_void_p)]
 
 class Interpolator(Structure):
     def __new__(cls, rebx, times, values, interpolation):
@@ -369,12 +499,13 @@ Interpolator._fields_ = [  ("interpolation", c_int),
                     ("values", POINTER(c_double)),
                     ("Nvalues", c_int),
                     ("y2", POINTER(c_double)),
-                    ("klo", c_int)]
+                    ("klo", c_int),
+                    ("_refcount", POINTER(c_int))]
 
 INTERPOLATION_TYPE = {"none":0, "spline":1}
 
 # This list keeps pairing from C rebx_param_type enum to ctypes type 1-to-1. Derive the required mappings from it
-REBX_C_TO_CTYPES = [["REBX_TYPE_NONE", None], ["REBX_TYPE_DOUBLE", c_double], ["REBX_TYPE_INT",c_int], ["REBX_TYPE_POINTER", c_void_p], ["REBX_TYPE_FORCE", Force], ["REBX_TYPE_UNIT32", c_uint32], ["REBX_TYPE_ORBIT", rebound.Orbit], ["REBX_TYPE_ODE", rebound.ODE], ["REBX_TYPE_VEC3D", rebound.Vec3d]]
+REBX_C_TO_CTYPES = [["REBX_TYPE_NONE", None], ["REBX_TYPE_DOUBLE", c_double], ["REBX_TYPE_INT",c_int], ["REBX_TYPE_POINTER", c_void_p], ["REBX_TYPE_FORCE", Force], ["REBX_TYPE_UNIT32", c_uint32], ["REBX_TYPE_ORBIT", rebound.Orbit], ["REBX_TYPE_ODE", rebound.ODE], ["REBX_TYPE_VEC3D", rebound.Vec3d], ["REBX_TYPE_DOUBLE_ARRAY", POINTER(c_double)], ["REBX_TYPE_INT_ARRAY", POINTER(c_int)]]
 REBX_CTYPES = {} # maps int value of rebx_param_type enum to ctypes type
 REBX_C_PARAM_TYPES = {} # maps string of rebx_param_type enum to int
 for i, pair in enumerate(REBX_C_TO_CTYPES):
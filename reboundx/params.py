@@ -4,7 +4,7 @@ if sys.version_info[:2] >= (3, 8):
     from collections.abc import MutableMapping
 else:
     from collections import MutableMapping
-from .extras import Param, Node, Force, Operator, Extras, REBX_CTYPES
+from .extras import Param, Node, Force, Operator, Extras, Interpolator, REBX_CTYPES
 from . import clibreboundx
 from ctypes import byref, c_double, c_int, c_int32, c_int64, c_uint, c_uint32, c_longlong, c_char_p, POINTER, cast
 from ctypes import c_void_p, memmove, sizeof, addressof
@@ -39,6 +39,12 @@ class Params(MutableMapping):
             if valptr is None:
                 raise AttributeError("REBOUNDx Error: Parameter '{0}' not found on object.".format(key))
             return valptr
+        elif ctype == POINTER(c_double) or ctype == POINTER(c_int): # arrays, return a list copy
+            clibreboundx.rebx_get_param_length.restype = c_int
+            length = clibreboundx.rebx_get_param_length(self.rebx, self.ap, c_char_p(key.encode('ascii')))
+            if length == 0 and valptr is None:
+                raise AttributeError("REBOUNDx Error: Parameter '{0}' not found on object.".format(key))
+            return cast(valptr, ctype)[:length]
         elif ctype == rebound.Vec3d:
             # Special case 
             valptr = cast(valptr, POINTER(rebound.Vec3dBasic))
@@ -61,12 +67,21 @@ class Params(MutableMapping):
         ctype = REBX_CTYPES[param_type]
         if ctype == None:
             raise AttributeError("REBOUNDx Error: Parameter '{0}' not found in REBOUNDx. Need to register it first.".format(key))
+        if isinstance(value, Interpolator): # REBOUNDx keeps its own copy and refreshes the value every timestep
+            clibreboundx.rebx_set_param_interpolator(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), byref(value))
+            return
         if ctype == c_double:
             clibreboundx.rebx_set_param_double(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), c_double(value))
         if ctype == c_int:
             clibreboundx.rebx_set_param_int(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), c_int(value))
         if ctype == c_uint32:
             clibreboundx.rebx_set_param_uint32(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), value)
+        if ctype == POINTER(c_double):
+            values = (c_double*len(value))(*value)
+            clibreboundx.rebx_set_param_array_double(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), values, c_int(len(value)))
+        if ctype == POINTER(c_int):
+            values = (c_int*len(value))(*value)
+            clibreboundx.rebx_set_param_array_int(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), values, c_int(len(value)))
         if ctype == rebound.Vec3d:
             clibreboundx.rebx_set_param_vec3d(self.rebx, byref(self.ap), c_char_p(key.encode('ascii')), rebound.Vec3d(value)._vec3d)
         if ctype == Force:
@@ -93,3 +108,57 @@ class Params(MutableMapping):
     def __len__(self):
         clibreboundx.rebx_len.restype = c_int
         return clibreboundx.rebx_len(self.ap)
+
+class ParticleParams(object):
+    """
+    Bulk access to a REBX_TYPE_DOUBLE parameter across the simulation's particles, e.g.
+
+    >>> rebx.particle_params['beta'] = np.full(sim.N, 0.1)
+    >>> betas = rebx.particle_params['beta'] # NaN for particles without beta
+
+    Values are passed to and from REBOUNDx as contiguous numpy arrays without per-particle calls.
+    """
+    def __init__(self, rebx):
+        self.rebx = rebx
+
+    def _indices(self, indices):
+        import numpy as np
+        N = self.rebx._sim.contents.N
+        if indices is None:
+            return None, 0, N
+        if isinstance(indices, slice):
+            start, stop, step = indices.indices(N)
+            if step == 1:
+                return None, start, max(stop-start, 0)
+            indices = np.arange(start, stop, step)
+        indices = np.ascontiguousarray(indices, dtype=np.intc)
+        return indices, 0, len(indices)
+
+    def get(self, name, indices=None):
+        """
+        Returns a numpy array with the parameter name for all particles, a slice, or an array of particle indices.
+        """
+        import numpy as np
+        idx, start, N = self._indices(indices)
+        values = np.empty(N, dtype=np.float64)
+        idxptr = None if idx is None else idx.ctypes.data_as(POINTER(c_int))
+        clibreboundx.rebx_get_particles_param_double(byref(self.rebx), c_char_p(name.encode('ascii')), c_int(start), idxptr, c_int(N), values.ctypes.data_as(POINTER(c_double)))
+        self.rebx.process_messages()
+        return values
+
+    def set(self, name, values, indices=None):
+        """
+        Sets the parameter name on all particles, a slice, or an array of particle indices. values can be an array or a scalar.
+        """
+        import numpy as np
+        idx, start, N = self._indices(indices)
+        values = np.ascontiguousarray(np.broadcast_to(np.asarray(values, dtype=np.float64), (N,)))
+        idxptr = None if idx is None else idx.ctypes.data_as(POINTER(c_int))
+        clibreboundx.rebx_set_particles_param_double(byref(self.rebx), c_char_p(name.encode('ascii')), c_int(start), idxptr, c_int(N), values.ctypes.data_as(POINTER(c_double)))
+        self.rebx.process_messages()
+
+    def __getitem__(self, name):
+        return self.get(name)
+
+    def __setitem__(self, name, values):
+        self.set(name, values)
@@ -1,6 +1,8 @@
 import rebound
 import reboundx
 import unittest
+from ctypes import byref
+from reboundx import clibreboundx
 
 class TestForces(unittest.TestCase):
     def setUp(self):
@@ -16,6 +18,17 @@ class TestForces(unittest.TestCase):
         with self.assertRaises(RuntimeError):
             gr = self.rebx.load_force('gr2')
 
+    def test_effectcapabilities(self):
+        self.assertEqual(self.rebx.effect_capabilities('gr'), {'force', 'velocity_dependent', 'has_energy', 'uses_gravity'})
+        self.assertEqual(self.rebx.effect_capabilities('track_min_distance'), {'operator', 'recorder', 'modifies_params'})
+        self.assertEqual(self.rebx.effect_capabilities('gr2'), set())
+
+    def test_unusedparamwarning(self):
+        lt = self.rebx.load_force('lense_thirring')
+        lt.params['c'] = 1.e4 # should be lt_c
+        with self.assertWarns(RuntimeWarning):
+            self.rebx.add_force(lt)
+
     def test_customforce(self):
         cust = self.rebx.create_force('myforce')
         def myforce(sim, force, particles, N):
@@ -40,6 +53,25 @@ class TestForces(unittest.TestCase):
         with self.assertRaises(RuntimeError):
             self.rebx.add_force(cust)
     
+    def test_participantsupdate(self):
+        # Compiled participant lists must pick up params set and particles added after the first force evaluation
+        def run(set_beta):
+            sim = rebound.Simulation()
+            sim.add(m=1.)
+            sim.add(a=1., e=0.2)
+            rebx = reboundx.Extras(sim)
+            rf = rebx.load_force('radiation_forces')
+            rebx.add_force(rf)
+            rf.params['c'] = 1.e4
+            sim.particles[1].params['beta'] = 0.5
+            sim.integrate(1.)
+            sim.add(a=2., e=0.1)
+            if set_beta:
+                sim.particles[2].params['beta'] = 0.5
+            sim.integrate(2.)
+            return sim.particles[2].x
+        self.assertNotEqual(run(True), run(False))
+
     def test_getforce(self):
         gr = self.rebx.load_force('gr')
         gr.params['gr_source'] = 3
@@ -73,6 +105,115 @@ class TestForces(unittest.TestCase):
         self.rebx.add_force(cust)
         self.rebx.remove_force(gr)
     
+    def test_removeforceafterstep(self):
+        gr = self.rebx.load_force('gr')
+        gr.params['c'] = 1.e4
+        self.rebx.add_force(gr)
+        cust = self.rebx.create_force('myforce')
+        self.ncalls = 0
+        def myforce(sim, force, particles, N):
+            self.ncalls += 1
+        cust.update_accelerations = myforce
+        cust.force_type = 'pos'
+        self.rebx.add_force(cust)
+        self.sim.step()
+        self.rebx.remove_force(gr)
+        ncalls = self.ncalls
+        self.sim.step()
+        self.assertGreater(self.ncalls, ncalls)
+
+    def test_parallelforces(self):
+        sims = []
+        for parallel in [0, 1]:
+            sim = rebound.Simulation()
+            sim.add(m=1.)
+            sim.add(m=1.e-3, a=1., e=0.2)
+            sim.add(m=1.e-3, a=2., e=0.1, inc=0.1)
+            rebx = reboundx.Extras(sim)
+            rebx.parallel_forces = parallel
+            gr = rebx.load_force('gr')
+            gr.params['c'] = 1.e2
+            rebx.add_force(gr)
+            grp = rebx.load_force('gr_potential')
+            grp.params['c'] = 1.e2
+            rebx.add_force(grp)
+            cust = rebx.create_force('myforce') # custom forces always run on their own
+            self.ncalls = 0
+            def myforce(sim, force, particles, N):
+                self.ncalls += 1
+            cust.update_accelerations = myforce
+            cust.force_type = 'pos'
+            rebx.add_force(cust)
+            sim.integrate(10.)
+            self.assertGreater(self.ncalls, 0)
+            sims.append(sim)
+        for p0, p1 in zip(sims[0].particles, sims[1].particles):
+            self.assertAlmostEqual(p0.x, p1.x, delta=1.e-10) # merged sums differ at the rounding level
+            self.assertAlmostEqual(p0.vy, p1.vy, delta=1.e-10)
+
+    def test_deterministicreductions(self):
+        sims = []
+        for deterministic in [0, 1, 1]:
+            sim = rebound.Simulation()
+            sim.add(m=1.)
+            for i in range(100): # enough particles to be split into several blocks
+                sim.add(m=1.e-6, a=1.+0.01*i, e=0.1, f=0.3*i)
+            rebx = reboundx.Extras(sim)
+            rebx.deterministic_reductions = deterministic
+            grp = rebx.load_force('gr_potential')
+            grp.params['c'] = 1.e2
+            rebx.add_force(grp)
+            sim.integrate(1.)
+            sims.append(sim)
+        self.assertAlmostEqual(sims[0].particles[0].x, sims[1].particles[0].x, delta=1.e-12)
+        self.assertEqual(sims[1].particles[0].x, sims[2].particles[0].x)
+        self.assertEqual(sims[1].particles[0].vx, sims[2].particles[0].vx)
+
+    def test_comforcebackreactions(self):
+        # Accelerations from modify_orbits_forces, computed with the earlier O(N^2) back-reaction sums
+        ref = {
+            'JACOBI': [[-5.9632980104832631e-08, 6.51057480413109e-07, 2.0904472173001487e-07],
+                [-0.00034660895700761219, -0.00054647613331079985, -8.1858973973691833e-05],
+                [0.00019054617345368958, -7.1237820518170263e-05, -7.0612529744080966e-05],
+                [0.00014393289076487391, 0.00016681818071963037, 6.4453200093067143e-05],
+                [-4.6816855177371233e-05, -4.5514796425783699e-05, -1.8187288314694605e-05]],
+            'BARYCENTRIC': [[-5.2335465916151647e-08, 6.5900754210509879e-07, 2.0796342649906965e-07],
+                [-0.00035495603863753915, -0.00054670651279868469, -8.1773547529800109e-05],
+                [0.00019149117902289499, -7.5375566327629733e-05, -7.0284165780045392e-05],
+                [0.00014235667430237582, 0.00016661178446504858, 6.4715554958033784e-05],
+                [-4.6869190643287176e-05, -4.4855788883678742e-05, -1.7979324888195548e-05]],
+            'PARTICLE': [[-6.8431991335085341e-08, 6.6731378995759477e-07, 2.093306650409368e-07],
+                [-0.00034620312090660076, -0.00054658061018103196, -8.1986032662759091e-05],
+                [0.00019156006133227082, -7.773455795980901e-05, -7.0463410972319103e-05],
+                [0.00014669785000800359, 0.0001674773579073864, 6.4228729578725256e-05],
+                [-4.1833935426857228e-05, -4.9002742810637919e-05, -1.8532175222902124e-05]],
+        }
+        particles = [(1., 0.01, -0.02, 0.003, 0.001, 0.002, -0.0005),
+                     (1.e-3, 1., 0.1, 0.02, -0.1, 1., 0.01),
+                     (2.e-3, -0.3, 1.9, -0.05, -0.7, -0.1, 0.02),
+                     (5.e-4, -2.8, -1.2, 0.1, 0.2, -0.55, -0.03),
+                     (1.e-3, 3.5, -2.5, -0.2, 0.3, 0.42, 0.01)]
+        for coordinates in ['JACOBI', 'BARYCENTRIC', 'PARTICLE']:
+            sim = rebound.Simulation()
+            for m, x, y, z, vx, vy, vz in particles:
+                sim.add(m=m, x=x, y=y, z=z, vx=vx, vy=vy, vz=vz)
+            rebx = reboundx.Extras(sim)
+            mof = rebx.load_force('modify_orbits_forces')
+            rebx.add_force(mof)
+            mof.params['coordinates'] = reboundx.coordinates[coordinates]
+            if coordinates == 'PARTICLE':
+                sim.particles[0].params['primary'] = 1
+            for i in range(1, sim.N):
+                sim.particles[i].params['tau_a'] = -1.e3*i
+                sim.particles[i].params['tau_e'] = -1.e2*i
+                sim.particles[i].params['tau_inc'] = -3.e2*i
+            for p in sim.particles:
+                p.ax, p.ay, p.az = 0., 0., 0.
+            clibreboundx.rebx_additional_forces(byref(sim))
+            for p, a in zip(sim.particles, ref[coordinates]):
+                for value, expected in zip((p.ax, p.ay, p.az), a):
+                    self.assertAlmostEqual(value, expected, delta=1.e-12*abs(expected))
+
     def test_removenonforce(self):
         with self.assertRaises(TypeError):
             self.rebx.remove_force(self.sim)
@@ -50,6 +50,18 @@ class TestGR(unittest.TestCase):
         E = self.rebx.gr_hamiltonian(self.force)
         self.assertLess(abs((E-E0)/E0), 1e-12)
 
+    def test_gr_tolerance(self):
+        self.force = self.rebx.load_force("gr")
+        self.rebx.add_force(self.force)
+        self.force.params['c'] = constants.C
+        E0 = self.rebx.gr_hamiltonian(self.force)
+        self.force.params['gr_tolerance'] = 1.e-8
+        self.force.params['max_iterations'] = 3
+        self.assertLess(abs((self.rebx.gr_hamiltonian(self.force)-E0)/E0), 1e-12)
+        self.sim.integrate(1e3)
+        E = self.rebx.gr_hamiltonian(self.force)
+        self.assertLess(abs((E-E0)/E0), 1e-12)
+
     def test_gr_full_energy(self):
         self.force = self.rebx.load_force("gr_full")
         self.rebx.add_force(self.force)
@@ -91,6 +103,50 @@ class TestGR(unittest.TestCase):
         x = sim2.particles[3].x
         self.assertLess(abs((x-x0)/x0), 1e-12)
 
+    def test_gr_full_tree(self):
+        def cluster(opening_angle):
+            sim = rebound.Simulation()
+            np.random.seed(1)
+            for i in range(64):
+                x, y, z = np.random.uniform(-1., 1., 3)
+                vx, vy, vz = np.random.uniform(-0.1, 0.1, 3)
+                sim.add(m=1./64, x=x, y=y, z=z, vx=vx, vy=vy, vz=vz)
+            sim.move_to_com()
+            rebx = reboundx.Extras(sim)
+            force = rebx.load_force("gr_full")
+            rebx.add_force(force)
+            force.params['c'] = 100.
+            if opening_angle is not None:
+                force.params['gr_opening_angle'] = opening_angle
+                force.params['gr_N_direct'] = 16
+            sim.integrate(0.1)
+            return np.array([[p.x, p.y, p.z] for p in sim.particles])
+
+        x0 = cluster(None)
+        self.assertTrue(np.array_equal(x0, cluster(0.)))
+        self.assertLess(np.max(np.abs(cluster(0.5) - x0)), 1e-6)
+
+    def test_gr_full_Nactive(self):
+        def integrate(N_active):
+            sim = rebound.Simulation()
+            sim.add(m=1., r=0.005)
+            sim.add(m=1.e-3, a=1.0, e=0.1)
+            for a in np.linspace(2., 4., 20):
+                sim.add(a=a, e=0.1)
+            sim.dt = sim.particles[1].P/20.2
+            sim.move_to_com()
+            sim.N_active = N_active
+            rebx = reboundx.Extras(sim)
+            force = rebx.load_force("gr_full")
+            rebx.add_force(force)
+            force.params['c'] = constants.C
+            sim.integrate(100.)
+            return np.array([[p.x, p.y, p.z] for p in sim.particles])
+
+        x0 = integrate(-1)
+        x = integrate(2)
+        self.assertLess(np.max(np.abs(x-x0)/np.abs(x0).max()), 1e-12)
+
     # add energy errors and gr gives same output with and without Nactive
 if __name__ == '__main__':
     unittest.main()
@@ -78,5 +78,39 @@ class TestConservation(unittest.TestCase):
         self.assertLess(abs((ps[0].m-m0)/m0), 1.e-2)
         self.assertLess(abs((ps[1].a-a10)/a10), 1.e-2)
     
+    def test_bound_param(self):
+        sim = self.sim
+        rebx = reboundx.Extras(sim)
+        gr = rebx.load_force("gr")
+        rebx.add_force(gr)
+        times = [0, 2000., 4000., 6000., 8000., 10000.]
+        values = [1.e4, 2.e4, 3.e4, 4.e4, 5.e4, 6.e4]
+        c = reboundx.Interpolator(rebx, times, values, "spline")
+        gr.params['c'] = c
+        self.assertAlmostEqual(gr.params['c'], 1.e4, delta=1.e-8)
+        cexpected = c.interpolate(rebx, t=3000.)
+        del c # REBOUNDx keeps its own copy
+        sim.integrate(3000.)
+        self.assertAlmostEqual(gr.params['c'], cexpected, delta=1.) # refreshed within the last timestep (c changes by ~0.3 per step)
+        gr.params['c'] = 1. # overrides the binding
+        sim.integrate(4000.)
+        self.assertEqual(gr.params['c'], 1.)
+
+    def test_copy_bound_param(self):
+        sim = self.sim
+        rebx = reboundx.Extras(sim)
+        gr = rebx.load_force("gr")
+        rebx.add_force(gr)
+        times = [0, 2000., 4000., 6000., 8000., 10000.]
+        values = [1.e4, 2.e4, 3.e4, 4.e4, 5.e4, 6.e4]
+        gr.params['c'] = reboundx.Interpolator(rebx, times, values, "spline")
+        sim2 = sim.copy()
+        rebx2 = rebx.copy(sim2)
+        gr2 = rebx2.get_force("gr")
+        sim.integrate(3000.)
+        sim2.integrate(3000.)
+        self.assertEqual(gr2.params['c'], gr.params['c'])
+        self.assertEqual(sim2.particles[1].x, sim.particles[1].x)
+
 if __name__ == '__main__':
     unittest.main()
@@ -184,6 +184,72 @@ class TestParams(unittest.TestCase):
         self.gr.params['my_new_int'] = 2
         self.assertEqual(self.gr.params["my_new_int"], 2)
 
+    def test_param_key(self):
+        from reboundx import clibreboundx
+        from ctypes import byref, c_char_p, c_int, c_void_p
+        key = clibreboundx.rebx_get_param_key(byref(self.rebx), c_char_p(b"c"))
+        self.assertGreaterEqual(key, 0)
+        self.assertEqual(clibreboundx.rebx_get_param_key(byref(self.rebx), c_char_p(b"asd;flkj")), -1)
+        self.gr.params['c'] = 1.2
+        clibreboundx.rebx_get_param_by_key.restype = c_void_p
+        valptr = clibreboundx.rebx_get_param_by_key(byref(self.rebx), self.gr.ap, c_int(key))
+        self.assertAlmostEqual(cast(valptr, POINTER(c_double)).contents.value, 1.2, delta=1.e-15)
+        param = cast(self.gr.ap.contents.object, POINTER(reboundx.extras.Param)).contents
+        self.assertEqual(param.key, key)
+
+    def test_user_param_keys(self):
+        from reboundx import clibreboundx
+        from ctypes import byref, c_char_p
+        keys = [clibreboundx.rebx_get_param_key(byref(self.rebx), c_char_p("my_param{0}".format(i).encode('ascii'))) for i in range(100)]
+        self.assertEqual(keys, [-1]*100)
+        for i in range(100):
+            self.rebx.register_param("my_param{0}".format(i), 'REBX_TYPE_DOUBLE')
+        keys = [clibreboundx.rebx_get_param_key(byref(self.rebx), c_char_p("my_param{0}".format(i).encode('ascii'))) for i in range(100)]
+        self.assertEqual(len(set(keys)), 100)
+        self.assertNotIn(clibreboundx.rebx_get_param_key(byref(self.rebx), c_char_p(b"c")), keys)
+        self.p.params['my_param99'] = 2.5
+        self.assertAlmostEqual(self.p.params['my_param99'], 2.5, delta=1.e-15)
+
+    def test_particle_params_array(self):
+        for i in range(8):
+            self.sim.add(a=2.+i)
+        betas = np.linspace(0.1, 0.8, self.sim.N)
+        self.rebx.particle_params['beta'] = betas
+        self.assertAlmostEqual(self.sim.particles[3].params['beta'], betas[3], delta=1.e-15)
+        self.assertTrue(np.array_equal(self.rebx.particle_params['beta'], betas))
+        self.rebx.particle_params.set('beta', 2., indices=[0, 5])
+        self.assertTrue(np.array_equal(self.rebx.particle_params.get('beta', indices=[5, 1]), [2., betas[1]]))
+        self.assertTrue(np.array_equal(self.rebx.particle_params.get('beta', indices=slice(1, 3)), betas[1:3]))
+        self.assertTrue(np.all(np.isnan(self.rebx.particle_params['tau_mass'])))
+        with self.assertRaises(RuntimeError):
+            self.rebx.particle_params.set('beta', 1., indices=[self.sim.N])
+        with self.assertRaises(RuntimeError):
+            self.rebx.particle_params['gr_source'] = 1.
+
+    def test_vec3d_uint32_roundtrip(self):
+        self.p.params['Omega'] = [1., 2., 3.]
+        self.p.params['min_distance_from'] = c_uint32(42)
+        self.sim.save_to_file("test_params.bin", delete_file=True)
+        self.rebx.save("test_params_rebx.bin")
+        sim2 = rebound.Simulation("test_params.bin")
+        rebx2 = reboundx.Extras(sim2, "test_params_rebx.bin")
+        self.assertAlmostEqual(sim2.particles[1].params['Omega'][2], 3., delta=1.e-15)
+        self.assertEqual(sim2.particles[1].params['min_distance_from'], 42)
+
+    def test_array_roundtrip(self):
+        self.rebx.register_param('my_darr', 'REBX_TYPE_DOUBLE_ARRAY')
+        self.rebx.register_param('my_iarr', 'REBX_TYPE_INT_ARRAY')
+        self.p.params['my_darr'] = [1.5, 2.5, 3.5]
+        self.p.params['my_darr'] = [4.5, 5.5] # resize
+        self.gr.params['my_iarr'] = [7, 8, 9]
+        self.assertEqual(self.p.params['my_darr'], [4.5, 5.5])
+        self.sim.save_to_file("test_params.bin", delete_file=True)
+        self.rebx.save("test_params_rebx.bin")
+        sim2 = rebound.Simulation("test_params.bin")
+        rebx2 = reboundx.Extras(sim2, "test_params_rebx.bin")
+        self.assertEqual(sim2.particles[1].params['my_darr'], [4.5, 5.5])
+        self.assertEqual(rebx2.get_force('gr').params['my_iarr'], [7, 8, 9])
+
     def test_length(self):
         self.gr.params['c'] = 1.3
         self.gr.params['gr_source'] = 7
@@ -1,6 +1,8 @@
 import rebound
 import reboundx
 import unittest
+import os
+import tempfile
 
 class TestRebx(unittest.TestCase):
     def setUp(self):
@@ -71,6 +73,110 @@ class TestRebx(unittest.TestCase):
         self.assertLess(Ltotnew[1], 1e-15)
         self.assertAlmostEqual(Ltotnew[2], L, delta=1e-15)
 
+    def test_copy(self):
+        gr = self.rebx.load_force('gr')
+        self.rebx.add_force(gr)
+        gr.params['c'] = 1e2
+        self.sim.particles[1].params['gr_source'] = 1
+        sim = self.sim.copy()
+        rebx = self.rebx.copy(sim)
+        grcopy = rebx.get_force('gr')
+        self.assertEqual(grcopy.params['c'], 1e2)
+        self.assertEqual(sim.particles[1].params['gr_source'], 1)
+        grcopy.params['c'] = 50. # independent of the original
+        self.assertEqual(gr.params['c'], 1e2)
+        self.sim.integrate(10.)
+        sim.integrate(10.)
+        self.assertNotEqual(sim.particles[1].x, self.sim.particles[1].x)
+
+    def test_pickle(self):
+        import pickle
+        gr = self.rebx.load_force('gr')
+        self.rebx.add_force(gr)
+        gr.params['c'] = 1e2
+        self.sim.particles[1].params['gr_source'] = 1
+        sim, rebx = pickle.loads(pickle.dumps((self.sim, self.rebx)))
+        self.assertIs(sim._extras_ref, rebx)
+        self.assertEqual(rebx.get_force('gr').params['c'], 1e2)
+        self.assertEqual(sim.particles[1].params['gr_source'], 1)
+        self.sim.integrate(10.)
+        sim.integrate(10.)
+        self.assertEqual(sim.particles[1].x, self.sim.particles[1].x)
+
+    def test_ensemble(self):
+        self.gr = self.rebx.load_force('gr')
+        self.rebx.add_force(self.gr)
+        self.gr.params['c'] = 1e2
+        cs = [50., 100., 200.]
+        results, status = self.rebx.integrate_ensemble(10., len(cs), params=[('c', 'gr', cs)], N_threads=2)
+        self.assertEqual(self.sim.t, 0.) # template untouched
+        self.assertEqual(results.shape, (3, 2, 6))
+        for k, c in enumerate(cs):
+            sim = self.sim.copy()
+            rebx = reboundx.Extras(sim)
+            gr = rebx.load_force('gr')
+            rebx.add_force(gr)
+            gr.params['c'] = c
+            sim.integrate(10.)
+            self.assertEqual(status[k], 0)
+            self.assertAlmostEqual(results[k, 1, 0], sim.particles[1].x, delta=1e-12)
+            self.assertAlmostEqual(results[k, 1, 4], sim.particles[1].vy, delta=1e-12)
+
+    @unittest.skipIf(os.name != 'posix', "rebx_integrate_ensemble_processes forks worker processes")
+    def test_ensemble_processes(self):
+        import mmap
+        from ctypes import Structure, byref, sizeof, c_char, c_char_p, c_double, c_int, c_void_p
+        from reboundx import clibreboundx
+        from reboundx.extras import Ensemble, EnsembleParam
+
+        class MemberRecord(Structure): # struct rebx_ensemble_member_record, followed by 16 doubles per particle
+            _fields_ = [("status", c_int),
+                        ("worker", c_int),
+                        ("t", c_double),
+                        ("energy_error", c_double)]
+
+        self.gr = self.rebx.load_force('gr')
+        self.rebx.add_force(self.gr)
+        self.gr.params['c'] = 1e2
+        cs = (c_double*2)(50., 200.)
+        params = (EnsembleParam*1)()
+        params[0].name = b'c'
+        params[0].effect = b'gr'
+        params[0].values = cs
+        status = (c_int*2)()
+        ensemble = Ensemble(N_members=2, tmax=10., N_params=1, params=params, status=status)
+        with tempfile.TemporaryDirectory() as tmpdir:
+            filename = os.path.join(tmpdir, 'ensemble.bin')
+            success = clibreboundx.rebx_integrate_ensemble_processes(byref(self.rebx), byref(ensemble), c_char_p(filename.encode('ascii')), c_int(2))
+            self.assertEqual(success, 1)
+            with open(filename, 'r+b') as f:
+                m = mmap.mmap(f.fileno(), 0)
+                header = (c_char*len(m)).from_buffer(m)
+                clibreboundx.rebx_ensemble_file_member.restype = c_void_p
+                for k in range(2):
+                    sim = self.sim.copy()
+                    rebx = reboundx.Extras(sim)
+                    gr = rebx.load_force('gr')
+                    rebx.add_force(gr)
+                    gr.params['c'] = cs[k]
+                    sim.integrate(10.)
+
+                    address = clibreboundx.rebx_ensemble_file_member(header, c_int(k))
+                    record = MemberRecord.from_address(address)
+                    particle = (c_double*16).from_address(address + sizeof(MemberRecord) + 16*sizeof(c_double)) # particles[1]
+                    self.assertEqual(status[k], 0)
+                    self.assertEqual(record.status, 0)
+                    self.assertEqual(record.t, sim.t)
+                    self.assertAlmostEqual(particle[0], sim.particles[1].x, delta=1e-12)
+                    self.assertAlmostEqual(particle[4], sim.particles[1].vy, delta=1e-12)
+                    del record, particle
+                del header
+                m.close()
+
+    def test_ensemble_bad_param(self):
+        with self.assertRaises(RuntimeError):
+            self.rebx.integrate_ensemble(1., 2, params=[('tau_a', 5, [1., 2.])])
+
 
 if __name__ == '__main__':
     unittest.main()
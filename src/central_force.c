@@ -60,9 +60,13 @@
 #include "rebound.h"
 #include "reboundx.h"
 
-static void rebx_calculate_central_force(struct reb_simulation* const sim, struct reb_particle* const particles, const int N, const double A, const double gamma, const int source_index){
+static void rebx_calculate_central_force(struct reb_simulation* const sim, struct rebx_acc_buffers* const buffers, struct reb_particle* const particles, const int N, const double A, const double gamma, const int source_index){
     const struct reb_particle source = particles[source_index];
-    for (int i=0; i<N; i++){
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+    for (int b=0; b<buffers->N_blocks; b++){
+    int start, end;
+    double* const acc_source = rebx_block_acc(buffers, b, &start, &end); // back-reaction on the source
+    for (int i=start; i<end; i++){
         if(i == source_index){
             continue;
         }
@@ -76,20 +80,30 @@ static void rebx_calculate_central_force(struct reb_simulation* const sim, struc
         particles[i].ax += prefac*dx;
         particles[i].ay += prefac*dy;
         particles[i].az += prefac*dz;
-        particles[source_index].ax -= p.m/source.m*prefac*dx;
-        particles[source_index].ay -= p.m/source.m*prefac*dy;
-        particles[source_index].az -= p.m/source.m*prefac*dz;
+        acc_source[0] -= p.m/source.m*prefac*dx;
+        acc_source[1] -= p.m/source.m*prefac*dy;
+        acc_source[2] -= p.m/source.m*prefac*dz;
     }
+    }
+    rebx_reduce_acc_buffers(buffers, particles, &source_index);
 }
 
 void rebx_central_force(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N){
-    for (int i=0; i<N; i++){
-        const double* const Acentral = rebx_get_param(sim->extras, particles[i].ap, "Acentral");
-        if (Acentral != NULL){
-            const double* const gammacentral = rebx_get_param(sim->extras, particles[i].ap, "gammacentral");
-            if (gammacentral != NULL){
-                rebx_calculate_central_force(sim, particles, N, *Acentral, *gammacentral, i); // only calculates force if a particle has both Acentral and gammacentral parameters set.
+    struct rebx_extras* const rebx = sim->extras;
+    const int keys[2] = {rebx_get_param_key(rebx, "Acentral"), rebx_get_param_key(rebx, "gammacentral")};
+    const struct rebx_participants* const sources = rebx_get_participants(rebx, force, particles, N, 2, keys);
+    if (sources == NULL){
+        return;
+    }
+    for (int j=0; j<sources->N; j++){
+        const double* const Acentral = sources->values[2*j];
+        const double* const gammacentral = sources->values[2*j+1];
+        if (Acentral != NULL && gammacentral != NULL){
+            struct rebx_acc_buffers* const buffers = rebx_get_acc_buffers(rebx, force, 1, N);
+            if (buffers == NULL){
+                return;
             }
+            rebx_calculate_central_force(sim, buffers, particles, N, *Acentral, *gammacentral, sources->indices[j]); // only calculates force if a particle has both Acentral and gammacentral parameters set.
         }
     }
 }
@@ -127,11 +141,13 @@ double rebx_central_force_potential(struct rebx_extras* const rebx){
     struct reb_simulation* sim = rebx->sim;
     const int N_real = sim->N - sim->N_var;
     struct reb_particle* const particles = sim->particles;
+    const int Acentral_key = rebx_get_param_key(rebx, "Acentral");
+    const int gammacentral_key = rebx_get_param_key(rebx, "gammacentral");
     double Htot = 0.;
     for (int i=0; i<N_real; i++){
-        const double* const Acentral = rebx_get_param(rebx, particles[i].ap, "Acentral");
+        const double* const Acentral = rebx_get_param_by_key(rebx, particles[i].ap, Acentral_key);
         if (Acentral != NULL){
-            const double* const gammacentral = rebx_get_param(rebx, particles[i].ap, "gammacentral");
+            const double* const gammacentral = rebx_get_param_by_key(rebx, particles[i].ap, gammacentral_key);
             if (gammacentral != NULL){
                 Htot += rebx_calculate_central_force_potential(sim, *Acentral, *gammacentral, i);
             }
@@ -34,6 +34,16 @@
 #include "core.h"
 #include "rebound.h"
 #include "linkedlist.h"
+#include "pool.h"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
 
 #define STRINGIFY(s) str(s)
 #define str(s) #s
@@ -45,145 +55,440 @@ const char* rebx_githash_str = STRINGIFY(REBXGITHASH);             // This line
 
 
 /*****************************
- Initialization routines.
+ Registered parameters.
  ****************************/
 
-void rebx_register_default_params(struct rebx_extras* rebx){
-    rebx_register_param(rebx, "c", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gr_source", REBX_TYPE_INT);
-    rebx_register_param(rebx, "tau_mass", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "force", REBX_TYPE_FORCE);
-    rebx_register_param(rebx, "particle", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "Acentral", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gammacentral", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "max_iterations", REBX_TYPE_INT);
-    rebx_register_param(rebx, "J2", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "J4", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "R_eq", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "coordinates", REBX_TYPE_INT);
-    rebx_register_param(rebx, "p", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "d_factor", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "cs_coeff", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_coeff", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_a", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_e", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_inc", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_omega", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_Omega", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "em_tau_a", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "em_aini", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "em_afin", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "primary", REBX_TYPE_INT);
-    rebx_register_param(rebx, "radiation_source", REBX_TYPE_INT);
-    rebx_register_param(rebx, "kappa", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "kappa_x", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "kappa_y", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "kappa_z", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_kappa", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_kappa_x", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_kappa_y", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau_kappa_z", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "stochastic_force_r", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "stochastic_force_phi", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "stochastic_force_x", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "stochastic_force_y", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "stochastic_force_z", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "beta", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tides_primary", REBX_TYPE_INT);
-    rebx_register_param(rebx, "R_tides", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tctl_k2", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tctl_tau", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "integrator", REBX_TYPE_INT);
-    rebx_register_param(rebx, "free_arrays", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "im_ps_final", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "im_ps_prev", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "im_ps_avg", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "rk2_k2", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "rk4_k2", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "rk4_k3", REBX_TYPE_POINTER);
-    rebx_register_param(rebx, "min_distance", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "min_distance_from", REBX_TYPE_UINT32);
-    rebx_register_param(rebx, "min_distance_orbit", REBX_TYPE_ORBIT);
-    rebx_register_param(rebx, "luminosity", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ide_position", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ide_width", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tIm_flaring_index", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tIm_scale_height_1", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tIm_surface_density_1", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tIm_surface_density_exponent", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_c", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_body_density", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_lstar", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_flag", REBX_TYPE_INT);
-    rebx_register_param(rebx, "ye_rotation_period", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_thermal_inertia", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_albedo", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_emissivity", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_k", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_stef_boltz", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_spin_axis_x", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_spin_axis_y", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ye_spin_axis_z", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "OmegaMag", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "Omega", REBX_TYPE_VEC3D);
-    rebx_register_param(rebx, "k2", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "I", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "tau", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "ode", REBX_TYPE_ODE);
-    rebx_register_param(rebx, "gas_df_rhog", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_alpha_rhog", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_cs", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_alpha_cs", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_xmin", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_hr", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "gas_df_Qd", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_R_eq", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_Mom_I_fac", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_rot_rate", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_p_hatx", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_p_haty", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_p_hatz", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "lt_c", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_M_last", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_num_apoapsis", REBX_TYPE_INT);
-    rebx_register_param(rebx, "td_c_imag", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_c_real", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_dP_hat", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_dP_crit", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_EB0", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_E_max", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_E_resid", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_dE_last", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_last_apoapsis", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_drag_coef", REBX_TYPE_DOUBLE);
-    rebx_register_param(rebx, "td_disruption_flag", REBX_TYPE_INT);
-}
-
-void rebx_register_param(struct rebx_extras* const rebx, const char* name, enum rebx_param_type type){
-
-    // check registered_params for entry
+// Parameters that are registered in every rebx_extras. The key of each is its index in this table, so it is the same across simulations.
+// New default parameters should be appended (the binary format stores names, so order only matters within a running program).
+static struct rebx_param rebx_default_params[] = {
+    {.name = "c",                             .type = REBX_TYPE_DOUBLE},
+    {.name = "gr_source",                     .type = REBX_TYPE_INT},
+    {.name = "tau_mass",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "force",                         .type = REBX_TYPE_FORCE},
+    {.name = "particle",                      .type = REBX_TYPE_POINTER},
+    {.name = "Acentral",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "gammacentral",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "max_iterations",                .type = REBX_TYPE_INT},
+    {.name = "J2",                            .type = REBX_TYPE_DOUBLE},
+    {.name = "J4",                            .type = REBX_TYPE_DOUBLE},
+    {.name = "R_eq",                          .type = REBX_TYPE_DOUBLE},
+    {.name = "coordinates",                   .type = REBX_TYPE_INT},
+    {.name = "p",                             .type = REBX_TYPE_DOUBLE},
+    {.name = "d_factor",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "cs_coeff",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_coeff",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_a",                         .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_e",                         .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_inc",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_omega",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_Omega",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "em_tau_a",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "em_aini",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "em_afin",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "primary",                       .type = REBX_TYPE_INT},
+    {.name = "radiation_source",              .type = REBX_TYPE_INT},
+    {.name = "kappa",                         .type = REBX_TYPE_DOUBLE},
+    {.name = "kappa_x",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "kappa_y",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "kappa_z",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_kappa",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_kappa_x",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_kappa_y",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "tau_kappa_z",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "stochastic_force_r",            .type = REBX_TYPE_DOUBLE},
+    {.name = "stochastic_force_phi",          .type = REBX_TYPE_DOUBLE},
+    {.name = "stochastic_force_x",            .type = REBX_TYPE_DOUBLE},
+    {.name = "stochastic_force_y",            .type = REBX_TYPE_DOUBLE},
+    {.name = "stochastic_force_z",            .type = REBX_TYPE_DOUBLE},
+    {.name = "beta",                          .type = REBX_TYPE_DOUBLE},
+    {.name = "tides_primary",                 .type = REBX_TYPE_INT},
+    {.name = "R_tides",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "tctl_k2",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "tctl_tau",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "integrator",                    .type = REBX_TYPE_INT},
+    {.name = "free_arrays",                   .type = REBX_TYPE_POINTER},
+    {.name = "im_ps_final",                   .type = REBX_TYPE_POINTER},
+    {.name = "im_ps_prev",                    .type = REBX_TYPE_POINTER},
+    {.name = "im_ps_avg",                     .type = REBX_TYPE_POINTER},
+    {.name = "rk2_k2",                        .type = REBX_TYPE_POINTER},
+    {.name = "rk4_k2",                        .type = REBX_TYPE_POINTER},
+    {.name = "rk4_k3",                        .type = REBX_TYPE_POINTER},
+    {.name = "min_distance",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "min_distance_from",             .type = REBX_TYPE_UINT32},
+    {.name = "min_distance_orbit",            .type = REBX_TYPE_ORBIT},
+    {.name = "luminosity",                    .type = REBX_TYPE_DOUBLE},
+    {.name = "ide_position",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "ide_width",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "tIm_flaring_index",             .type = REBX_TYPE_DOUBLE},
+    {.name = "tIm_scale_height_1",            .type = REBX_TYPE_DOUBLE},
+    {.name = "tIm_surface_density_1",         .type = REBX_TYPE_DOUBLE},
+    {.name = "tIm_surface_density_exponent",  .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_c",                          .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_body_density",               .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_lstar",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_flag",                       .type = REBX_TYPE_INT},
+    {.name = "ye_rotation_period",            .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_thermal_inertia",            .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_albedo",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_emissivity",                 .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_k",                          .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_stef_boltz",                 .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_spin_axis_x",                .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_spin_axis_y",                .type = REBX_TYPE_DOUBLE},
+    {.name = "ye_spin_axis_z",                .type = REBX_TYPE_DOUBLE},
+    {.name = "OmegaMag",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "Omega",                         .type = REBX_TYPE_VEC3D},
+    {.name = "k2",                            .type = REBX_TYPE_DOUBLE},
+    {.name = "I",                             .type = REBX_TYPE_DOUBLE},
+    {.name = "tau",                           .type = REBX_TYPE_DOUBLE},
+    {.name = "ode",                           .type = REBX_TYPE_ODE},
+    {.name = "gas_df_rhog",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_alpha_rhog",             .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_cs",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_alpha_cs",               .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_xmin",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_hr",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "gas_df_Qd",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_R_eq",                       .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_Mom_I_fac",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_rot_rate",                   .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_p_hatx",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_p_haty",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_p_hatz",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "lt_c",                          .type = REBX_TYPE_DOUBLE},
+    {.name = "td_M_last",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "td_num_apoapsis",               .type = REBX_TYPE_INT},
+    {.name = "td_c_imag",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "td_c_real",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "td_dP_hat",                     .type = REBX_TYPE_DOUBLE},
+    {.name = "td_dP_crit",                    .type = REBX_TYPE_DOUBLE},
+    {.name = "td_EB0",                        .type = REBX_TYPE_DOUBLE},
+    {.name = "td_E_max",                      .type = REBX_TYPE_DOUBLE},
+    {.name = "td_E_resid",                    .type = REBX_TYPE_DOUBLE},
+    {.name = "td_dE_last",                    .type = REBX_TYPE_DOUBLE},
+    {.name = "td_last_apoapsis",              .type = REBX_TYPE_DOUBLE},
+    {.name = "td_drag_coef",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "td_disruption_flag",            .type = REBX_TYPE_INT},
+    {.name = "gr_tolerance",                  .type = REBX_TYPE_DOUBLE},
+    {.name = "gr_opening_angle",              .type = REBX_TYPE_DOUBLE},
+    {.name = "gr_N_direct",                   .type = REBX_TYPE_INT},
+};
+
+#define REBX_N_DEFAULT_PARAMS ((int)(sizeof(rebx_default_params)/sizeof(rebx_default_params[0])))
+#define REBX_DEFAULT_PARAM_INDEX_SIZE 512   // power of 2, kept well above 2*REBX_N_DEFAULT_PARAMS
+
+// Open addressing hash indices map names to key+1 (0 marks an empty slot).
+// The default index only depends on the static table above, so it is filled once (see rebx_build_static_indices) and then shared read-only by all rebx_extras.
+static int rebx_default_param_index[REBX_DEFAULT_PARAM_INDEX_SIZE];
+
+static uint32_t rebx_hash_name(const char* name){ // FNV-1a
+    uint32_t hash = 2166136261u;
+    for (; *name != '\0'; name++){
+        hash ^= (unsigned char)*name;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+struct rebx_param* rebx_get_registered_param(struct rebx_extras* const rebx, const int key){
+    if (key < REBX_N_DEFAULT_PARAMS){
+        return &rebx_default_params[key];
+    }
+    return rebx->param_keys[key - REBX_N_DEFAULT_PARAMS];
+}
+
+static void rebx_index_insert(int* const index, const int mask, const char* const name, const int key){
+    uint32_t slot = rebx_hash_name(name) & mask;
+    while (index[slot] != 0){
+        slot = (slot + 1) & mask;
+    }
+    index[slot] = key + 1;
+}
+
+static int rebx_index_lookup(struct rebx_extras* const rebx, const int* const index, const int mask, const char* const name){
+    uint32_t slot = rebx_hash_name(name) & mask;
+    while (index[slot] != 0){
+        const int key = index[slot] - 1;
+        if (strcmp(rebx_get_registered_param(rebx, key)->name, name) == 0){
+            return key;
+        }
+        slot = (slot + 1) & mask;
+    }
+    return -1;
+}
+
+static void rebx_build_default_param_index(void){
+    for (int key=0; key<REBX_N_DEFAULT_PARAMS; key++){
+        rebx_default_params[key].key = key;
+        rebx_index_insert(rebx_default_param_index, REBX_DEFAULT_PARAM_INDEX_SIZE-1, rebx_default_params[key].name, key);
+    }
+}
+
+int rebx_register_param(struct rebx_extras* const rebx, const char* name, enum rebx_param_type type){
+
+    // check registered params for entry
     enum rebx_param_type reg_type = rebx_get_type(rebx, name);
 
     if (reg_type != REBX_TYPE_NONE){
         char str[300];
         sprintf(str, "REBOUNDx Error: Parameter name '%s' already in registered list. Cannot add duplicates.\n", name);
         rebx_error(rebx, str);
-        return;
+        return -1;
     }
 
     // Create new entry. These are just rebx_param structs without value populated
     struct rebx_param* param = rebx_create_param(rebx, name, type);
     if (param == NULL){
-        return;
+        return -1;
     }
     int success = rebx_add_param(rebx, &rebx->registered_params, param);
     if(!success){
         rebx_free_param(param);
+        return -1;
     }
 
-    return;
+    return rebx_intern_param(rebx, param);
+}
+
+// Rebuilds the user index with room for at least N_keys user registered params at load factor <= 1/2
+static int rebx_grow_param_index(struct rebx_extras* const rebx, const int N_keys){
+    int N_allocated = rebx->N_allocated_param_index ? rebx->N_allocated_param_index : 64;
+    while (2*N_keys > N_allocated){
+        N_allocated *= 2;
+    }
+    if (N_allocated == rebx->N_allocated_param_index){
+        return 1;
+    }
+    int* index = calloc(N_allocated, sizeof(*index));
+    if (index == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+        return 0;
+    }
+    for (int key=REBX_N_DEFAULT_PARAMS; key<rebx->N_param_keys; key++){
+        rebx_index_insert(index, N_allocated-1, rebx_get_registered_param(rebx, key)->name, key);
+    }
+    free(rebx->param_index);
+    rebx->param_index = index;
+    rebx->N_allocated_param_index = N_allocated;
+    return 1;
+}
+
+int rebx_intern_param(struct rebx_extras* const rebx, struct rebx_param* const reg_param){
+    const int N_user_keys = rebx->N_param_keys - REBX_N_DEFAULT_PARAMS;
+    if (N_user_keys >= rebx->N_allocated_param_keys){
+        int N_allocated = rebx->N_allocated_param_keys ? 2*rebx->N_allocated_param_keys : 16;
+        struct rebx_param** param_keys = realloc(rebx->param_keys, N_allocated*sizeof(*param_keys));
+        if (param_keys == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+            return -1;
+        }
+        rebx->param_keys = param_keys;
+        rebx->N_allocated_param_keys = N_allocated;
+    }
+    if (!rebx_grow_param_index(rebx, N_user_keys + 1)){
+        return -1;
+    }
+    const int key = rebx->N_param_keys;
+    rebx->param_keys[N_user_keys] = reg_param;
+    reg_param->key = key;
+    rebx->N_param_keys++;
+    rebx_index_insert(rebx->param_index, rebx->N_allocated_param_index-1, reg_param->name, key);
+    return key;
+}
+
+/*****************************
+ Built-in effects.
+ ****************************/
+
+// Parameters set on a force by the operators that integrate it (see integrate_force.c)
+static const char* const rebx_integrated_force_params[] = {"free_arrays", "im_ps_final", "im_ps_prev", "im_ps_avg", "rk2_k2", "rk4_k2", "rk4_k3", NULL};
+
+// Descriptor for each built-in force or operator. Only parameters attached to the force/operator itself are listed, not the ones on particles.
+struct rebx_effect_descriptor{
+    const char* name;
+    void (*update_accelerations) (struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N);
+    enum rebx_force_type force_type;
+    void (*step_function) (struct reb_simulation* const sim, struct rebx_operator* const operator, const double dt);
+    enum rebx_operator_type operator_type;
+    const char* const* required_params;     // NULL terminated (or NULL)
+    const char* const* optional_params;
+    unsigned int capabilities;              // flags not implied by force_type / operator_type
+    const char* load_warning;               // issued by rebx_load_force / rebx_load_operator, if not NULL
+};
+
+static const struct rebx_effect_descriptor rebx_effects[] = {
+    {.name = "gr", .update_accelerations = rebx_gr, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"c", NULL}, .optional_params = (const char*[]){"max_iterations", "gr_tolerance", NULL},
+        .capabilities = REBX_EFFECT_HAS_ENERGY | REBX_EFFECT_USES_GRAVITY},
+    {.name = "central_force", .update_accelerations = rebx_central_force, .force_type = REBX_FORCE_POS,
+        .capabilities = REBX_EFFECT_HAS_ENERGY},
+    {.name = "modify_orbits_forces", .update_accelerations = rebx_modify_orbits_forces, .force_type = REBX_FORCE_VEL,
+        .optional_params = (const char*[]){"coordinates", "ide_position", "ide_width", NULL}},
+    {.name = "gas_damping_timescale", .update_accelerations = rebx_gas_damping_timescale, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"cs_coeff", "tau_coeff", NULL}, .optional_params = (const char*[]){"coordinates", NULL}},
+    {.name = "exponential_migration", .update_accelerations = rebx_exponential_migration, .force_type = REBX_FORCE_VEL,
+        .optional_params = (const char*[]){"coordinates", NULL}},
+    {.name = "gr_full", .update_accelerations = rebx_gr_full, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"c", NULL}, .optional_params = (const char*[]){"max_iterations", "gr_opening_angle", "gr_N_direct", NULL},
+        .capabilities = REBX_EFFECT_HAS_ENERGY},
+    {.name = "gravitational_harmonics", .update_accelerations = rebx_gravitational_harmonics, .force_type = REBX_FORCE_POS,
+        .capabilities = REBX_EFFECT_HAS_ENERGY},
+    {.name = "gr_potential", .update_accelerations = rebx_gr_potential, .force_type = REBX_FORCE_POS,
+        .required_params = (const char*[]){"c", NULL},
+        .capabilities = REBX_EFFECT_HAS_ENERGY},
+    {.name = "radiation_forces", .update_accelerations = rebx_radiation_forces, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"c", NULL}},
+    {.name = "stochastic_forces", .update_accelerations = rebx_stochastic_forces, .force_type = REBX_FORCE_VEL,
+        .capabilities = REBX_EFFECT_MODIFIES_PARAMS | REBX_EFFECT_RANDOM},
+    {.name = "tides_constant_time_lag", .update_accelerations = rebx_tides_constant_time_lag, .force_type = REBX_FORCE_VEL,
+        .capabilities = REBX_EFFECT_HAS_ENERGY},
+    {.name = "type_I_migration", .update_accelerations = rebx_modify_orbits_with_type_I_migration, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"tIm_surface_density_1", "tIm_scale_height_1", "tIm_surface_density_exponent", "tIm_flaring_index", NULL},
+        .optional_params = (const char*[]){"coordinates", "ide_position", "ide_width", NULL}},
+    {.name = "tides_spin", .update_accelerations = rebx_tides_spin, .force_type = REBX_FORCE_VEL,
+        .optional_params = (const char*[]){"ode", NULL},
+        .capabilities = REBX_EFFECT_HAS_ENERGY,
+        .load_warning = "tides_spin was updated in version 4.5.0 to halve the acceleration from the conservative piece of the tidal potential, reflecting a typo discovered in Eggleton et. al (1998). This warning will be removed in a future version.\n"},
+    {.name = "yarkovsky_effect", .update_accelerations = rebx_yarkovsky_effect, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"ye_lstar", "ye_c", NULL}, .optional_params = (const char*[]){"ye_stef_boltz", NULL}},
+    {.name = "gas_dynamical_friction", .update_accelerations = rebx_gas_dynamical_friction, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"gas_df_rhog", "gas_df_alpha_rhog", "gas_df_cs", "gas_df_alpha_cs", "gas_df_xmin", "gas_df_hr", "gas_df_Qd", NULL}},
+    {.name = "lense_thirring", .update_accelerations = rebx_lense_thirring, .force_type = REBX_FORCE_VEL,
+        .required_params = (const char*[]){"lt_c", NULL}},
+    {.name = "tides_dynamical", .update_accelerations = rebx_tides_dynamical, .force_type = REBX_FORCE_VEL,
+        .optional_params = (const char*[]){"td_disruption_flag", NULL},
+        .capabilities = REBX_EFFECT_MODIFIES_PARAMS},
+    {.name = "modify_mass", .step_function = rebx_modify_mass, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "integrate_force", .step_function = rebx_integrate_force, .operator_type = REBX_OPERATOR_UPDATER,
+        .required_params = (const char*[]){"force", NULL}, .optional_params = (const char*[]){"integrator", NULL},
+        .capabilities = REBX_EFFECT_MODIFIES_PARAMS},
+    {.name = "drift", .step_function = rebx_drift_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "kick", .step_function = rebx_kick_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "kepler", .step_function = rebx_kepler_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "jump", .step_function = rebx_jump_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "interaction", .step_function = rebx_interaction_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "ias15", .step_function = rebx_ias15_step, .operator_type = REBX_OPERATOR_UPDATER},
+    {.name = "modify_orbits_direct", .step_function = rebx_modify_orbits_direct, .operator_type = REBX_OPERATOR_UPDATER,
+        .optional_params = (const char*[]){"p", "coordinates", "ide_position", "ide_width", NULL}},
+    {.name = "track_min_distance", .step_function = rebx_track_min_distance, .operator_type = REBX_OPERATOR_RECORDER,
+        .capabilities = REBX_EFFECT_MODIFIES_PARAMS},
+};
+
+#define REBX_N_EFFECTS ((int)(sizeof(rebx_effects)/sizeof(rebx_effects[0])))
+#define REBX_EFFECT_INDEX_SIZE 128   // power of 2, kept well above 2*REBX_N_EFFECTS
+
+// Maps names to index+1 in rebx_effects (0 marks an empty slot). Like the default param index, filled once and then read-only.
+static int rebx_effect_index[REBX_EFFECT_INDEX_SIZE];
+
+static void rebx_build_effect_index(void){
+    for (int i=0; i<REBX_N_EFFECTS; i++){
+        uint32_t slot = rebx_hash_name(rebx_effects[i].name) & (REBX_EFFECT_INDEX_SIZE-1);
+        while (rebx_effect_index[slot] != 0){
+            slot = (slot + 1) & (REBX_EFFECT_INDEX_SIZE-1);
+        }
+        rebx_effect_index[slot] = i + 1;
+    }
+}
+
+// The static indices are built exactly once, even if several threads attach their first simulations at the same time.
+// Inserting concurrently could duplicate entries and fill the tables, so lookups would never find an empty slot.
+static void rebx_build_static_indices(void){
+    rebx_build_default_param_index();
+    rebx_build_effect_index();
+}
+
+#ifdef _WIN32
+static INIT_ONCE rebx_static_indices_once = INIT_ONCE_STATIC_INIT;
+
+static BOOL CALLBACK rebx_build_static_indices_win32(PINIT_ONCE once, PVOID parameter, PVOID* context){
+    rebx_build_static_indices();
+    return TRUE;
+}
+
+static void rebx_init_static_indices(void){
+    InitOnceExecuteOnce(&rebx_static_indices_once, rebx_build_static_indices_win32, NULL, NULL);
+}
+#else
+static pthread_once_t rebx_static_indices_once = PTHREAD_ONCE_INIT;
+
+static void rebx_init_static_indices(void){
+    pthread_once(&rebx_static_indices_once, rebx_build_static_indices);
+}
+#endif
+
+static const struct rebx_effect_descriptor* rebx_get_effect_descriptor(const char* const name){
+    if (name == NULL){
+        return NULL;
+    }
+    rebx_init_static_indices();
+    uint32_t slot = rebx_hash_name(name) & (REBX_EFFECT_INDEX_SIZE-1);
+    while (rebx_effect_index[slot] != 0){
+        const struct rebx_effect_descriptor* const effect = &rebx_effects[rebx_effect_index[slot]-1];
+        if (strcmp(effect->name, name) == 0){
+            return effect;
+        }
+        slot = (slot + 1) & (REBX_EFFECT_INDEX_SIZE-1);
+    }
+    return NULL;
+}
+
+unsigned int rebx_get_effect_capabilities(const char* name){
+    const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(name);
+    if (effect == NULL){
+        return 0;
+    }
+    unsigned int capabilities = effect->capabilities;
+    if (effect->update_accelerations){
+        capabilities |= REBX_EFFECT_FORCE;
+        if (effect->force_type == REBX_FORCE_VEL){
+            capabilities |= REBX_EFFECT_VELOCITY_DEPENDENT;
+        }
+    }
+    if (effect->step_function){
+        capabilities |= REBX_EFFECT_OPERATOR;
+        if (effect->operator_type == REBX_OPERATOR_RECORDER){
+            capabilities |= REBX_EFFECT_RECORDER;
+        }
+    }
+    return capabilities;
 }
 
+static int rebx_name_in_list(const char* const* list, const char* const name){
+    if (list == NULL){
+        return 0;
+    }
+    for (; *list != NULL; list++){
+        if (strcmp(*list, name) == 0){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// Warns about default parameters attached to a built-in effect that it never reads (typically a typo, e.g. "c" instead of "lt_c").
+// Missing required parameters are not flagged here, since they can still be set after the effect is added.
+static void rebx_check_effect_params(struct rebx_extras* const rebx, const struct rebx_effect_descriptor* const effect, struct rebx_node* ap){
+    for (struct rebx_node* current = ap; current != NULL; current = current->next){
+        const struct rebx_param* const param = current->object;
+        if (param->key < 0 || param->key >= REBX_N_DEFAULT_PARAMS){ // user registered (or unregistered) params are the user's business
+            continue;
+        }
+        if (rebx_name_in_list(effect->required_params, param->name) || rebx_name_in_list(effect->optional_params, param->name)){
+            continue;
+        }
+        if (effect->update_accelerations && rebx_name_in_list(rebx_integrated_force_params, param->name)){
+            continue;
+        }
+        char str[300];
+        snprintf(str, sizeof(str), "REBOUNDx Warning: Parameter '%s' is not used by '%s'. Check the documentation for its parameter names.\n", param->name, effect->name);
+        reb_simulation_warning(rebx->sim, str);
+    }
+}
+
+/*****************************
+ Initialization routines.
+ ****************************/
+
 struct rebx_extras* rebx_attach(struct reb_simulation* sim){  // reboundx.h
     if (sim == NULL){
         fprintf(stderr, "REBOUNDx Error: Simulation pointer passed to rebx_attach was NULL.\n");
@@ -191,7 +496,20 @@ struct rebx_extras* rebx_attach(struct reb_simulation* sim){  // reboundx.h
     }
     struct rebx_extras* rebx = malloc(sizeof(*rebx));
     rebx_initialize(sim, rebx);
-    rebx_register_default_params(rebx);
+    return rebx;
+}
+
+struct rebx_extras* rebx_copy(struct reb_simulation* sim_dst, struct rebx_extras* rebx_src){ // reboundx.h
+    if (sim_dst == NULL){
+        fprintf(stderr, "REBOUNDx Error: Simulation pointer passed to rebx_copy was NULL.\n");
+        return NULL;
+    }
+    struct rebx_extras* rebx = rebx_attach(sim_dst);
+    if (!rebx_copy_extras(rebx, rebx_src)){
+        rebx_detach(sim_dst, rebx);
+        rebx_free(rebx);
+        return NULL;
+    }
     return rebx;
 }
 
@@ -219,6 +537,9 @@ void rebx_detach(struct reb_simulation* sim, struct rebx_extras* rebx){
         if (sim->free_particle_ap == rebx_free_particle_ap){
             sim->free_particle_ap = NULL;
         }
+        if (sim->extras_cleanup == rebx_extras_cleanup){ // so freeing the simulation after rebx_free doesn't touch the freed extras
+            sim->extras_cleanup = NULL;
+        }
     }
 }
 
@@ -236,6 +557,24 @@ void rebx_initialize(struct reb_simulation* sim, struct rebx_extras* rebx){
     rebx->allocated_forces=NULL;
     rebx->allocated_operators=NULL;
     rebx->registered_params=NULL;
+    rebx->param_keys=NULL;
+    rebx->N_param_keys=REBX_N_DEFAULT_PARAMS;
+    rebx->N_allocated_param_keys=0;
+    rebx->param_index=NULL;
+    rebx->N_allocated_param_index=0;
+    rebx->plan=NULL;
+    rebx->interpolated_params=NULL;
+    rebx->N_interpolated_params=0;
+    rebx->N_allocated_interpolated_params=0;
+    rebx->interpolated_params_t=NAN;
+    rebx->parallel_forces=0;
+    rebx->deterministic_reductions=0;
+    rebx_init_static_indices();
+    rebx->param_generation=0;
+    rebx->pool = rebx_pool_create();
+    if (rebx->pool == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for parameter pool.\n");
+    }
 
     sim->free_particle_ap = rebx_free_particle_ap;
     sim->extras_cleanup = rebx_extras_cleanup;
@@ -267,6 +606,10 @@ struct rebx_force* rebx_create_force(struct rebx_extras* const rebx, const char*
     force->sim = rebx->sim;
     force->force_type = REBX_FORCE_NONE;
     force->update_accelerations = NULL;
+    force->participants = NULL;
+    force->acc_buffers = NULL;
+    force->workspace = NULL;
+    force->workspace_size = 0;
     force->name = NULL;
     if(name != NULL)
     {
@@ -297,82 +640,19 @@ struct rebx_force* rebx_load_force(struct rebx_extras* const rebx, const char* n
     if (force == NULL){
         return NULL;
     }
-    if(strcmp(name, "gr") == 0){
-        force->update_accelerations = rebx_gr;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "central_force") == 0){
-        force->update_accelerations = rebx_central_force;
-        force->force_type = REBX_FORCE_POS;
-    }
-    else if (strcmp(name, "modify_orbits_forces") == 0){
-        force->update_accelerations = rebx_modify_orbits_forces;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "gas_damping_timescale") == 0){
-        force->update_accelerations = rebx_gas_damping_timescale;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "exponential_migration") == 0){
-        force->update_accelerations = rebx_exponential_migration;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "gr_full") == 0){
-        force->update_accelerations = rebx_gr_full;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "gravitational_harmonics") == 0){
-        force->update_accelerations = rebx_gravitational_harmonics;
-        force->force_type = REBX_FORCE_POS;
-    }
-    else if (strcmp(name, "gr_potential") == 0){
-        force->update_accelerations = rebx_gr_potential;
-        force->force_type = REBX_FORCE_POS;
-    }
-    else if (strcmp(name, "radiation_forces") == 0){
-        force->update_accelerations = rebx_radiation_forces;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "stochastic_forces") == 0){
-        force->update_accelerations = rebx_stochastic_forces;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "tides_constant_time_lag") == 0){
-        force->update_accelerations = rebx_tides_constant_time_lag;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "type_I_migration") == 0){
-        force->update_accelerations = rebx_modify_orbits_with_type_I_migration;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "tides_spin") == 0){
-        reb_simulation_warning(rebx->sim, "tides_spin was updated in version 4.5.0 to halve the acceleration from the conservative piece of the tidal potential, reflecting a typo discovered in Eggleton et. al (1998). This warning will be removed in a future version.\n");
-        force->update_accelerations = rebx_tides_spin;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "yarkovsky_effect") == 0){
-        force->update_accelerations = rebx_yarkovsky_effect;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "gas_dynamical_friction") == 0){
-        force->update_accelerations = rebx_gas_dynamical_friction;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "lense_thirring") == 0){
-        force->update_accelerations = rebx_lense_thirring;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else if (strcmp(name, "tides_dynamical") == 0){
-        force->update_accelerations = rebx_tides_dynamical;
-        force->force_type = REBX_FORCE_VEL;
-    }
-    else{
+    const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(name);
+    if (effect == NULL || effect->update_accelerations == NULL){
         char str[300];
         sprintf(str, "REBOUNDx error: Force '%s' not found in REBOUNDx library.\n", name);
         rebx_error(rebx, str);
         rebx_remove_force(rebx, force); // Not free_force. Must remove from allocated_forces
         return NULL;
     }
+    if (effect->load_warning != NULL){
+        reb_simulation_warning(rebx->sim, effect->load_warning);
+    }
+    force->update_accelerations = effect->update_accelerations;
+    force->force_type = effect->force_type;
 
     return force;
 }
@@ -394,7 +674,7 @@ struct rebx_operator* rebx_create_operator(struct rebx_extras* const rebx, const
     if(name != NULL){
         operator->name = rebx_malloc(rebx, strlen(name) + 1); // +1 for \0 at end
         if (operator->name == NULL){
-            rebx_free_operator(operator);
+            rebx_free_operator(rebx, operator);
             return NULL;
         }
         else{
@@ -405,7 +685,7 @@ struct rebx_operator* rebx_create_operator(struct rebx_extras* const rebx, const
     // Add operator to allocated_operators list for later freeing
     struct rebx_node* node = rebx_create_node(rebx);
     if (node == NULL){
-        rebx_free_operator(operator);
+        rebx_free_operator(rebx, operator);
         return NULL;
     }
     node->object = operator;
@@ -419,53 +699,19 @@ struct rebx_operator* rebx_load_operator(struct rebx_extras* const rebx, const c
     if (operator == NULL){
         return NULL;
     }
-    if (strcmp(name, "modify_mass") == 0){
-        operator->step_function = rebx_modify_mass;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "integrate_force") == 0){
-        operator->step_function = rebx_integrate_force;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "drift") == 0){
-        operator->step_function = rebx_drift_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "kick") == 0){
-        operator->step_function = rebx_kick_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "kepler") == 0){
-        operator->step_function = rebx_kepler_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "jump") == 0){
-        operator->step_function = rebx_jump_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "interaction") == 0){
-        operator->step_function = rebx_interaction_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "ias15") == 0){
-        operator->step_function = rebx_ias15_step;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "modify_orbits_direct") == 0){
-        operator->step_function = rebx_modify_orbits_direct;
-        operator->operator_type = REBX_OPERATOR_UPDATER;
-    }
-    else if (strcmp(name, "track_min_distance") == 0){
-        operator->step_function = rebx_track_min_distance;
-        operator->operator_type = REBX_OPERATOR_RECORDER;
-    }
-    else{
+    const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(name);
+    if (effect == NULL || effect->step_function == NULL){
         char str[300];
         sprintf(str, "REBOUNDx error: Operator '%s' not found in REBOUNDx library.\n", name);
         rebx_error(rebx, str);
         rebx_remove_operator(rebx, operator); // Not free_op. Must rm from allocated_forces
         return NULL;
     }
+    if (effect->load_warning != NULL){
+        reb_simulation_warning(rebx->sim, effect->load_warning);
+    }
+    operator->step_function = effect->step_function;
+    operator->operator_type = effect->operator_type;
     return operator;
 }
 
@@ -494,6 +740,11 @@ int rebx_add_force(struct rebx_extras* rebx, struct rebx_force* force){
         rebx->sim->force_is_velocity_dependent = 1;
     }
 
+    const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(force->name);
+    if (effect != NULL && effect->update_accelerations == force->update_accelerations){ // built-in, not a custom force with the same name
+        rebx_check_effect_params(rebx, effect, force->ap);
+    }
+
     // Could add logic based on different integrators
     struct rebx_node* node = rebx_create_node(rebx);
     if (node == NULL){
@@ -501,6 +752,7 @@ int rebx_add_force(struct rebx_extras* rebx, struct rebx_force* force){
     }
     node->object = force;
     rebx_add_node(&rebx->additional_forces, node);
+    rebx_invalidate_plan(rebx);
     if (rebx->sim->additional_forces != NULL && rebx->sim->additional_forces != rebx_additional_forces){
         reb_simulation_warning(rebx->sim, "REBOUNDx Warning: additional_forces was set and is being overwritten by REBOUNDx. To incorporate both, you can add your own custom effects through REBOUNDx.  See https://github.com/dtamayo/reboundx/blob/master/ipython_examples/Custom_Effects.ipynb for a tutorial.\n");
     }
@@ -540,6 +792,7 @@ int rebx_add_operator_step(struct rebx_extras* rebx, struct rebx_operator* opera
         return 0;
     }
     node->object = step;
+    rebx_invalidate_plan(rebx);
 
     if (timing == REBX_TIMING_PRE){
         rebx_add_node(&rebx->pre_timestep_modifications, node);
@@ -570,6 +823,11 @@ int rebx_add_operator(struct rebx_extras* rebx, struct rebx_operator* operator){
         return 0;
     }
 
+    const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(operator->name);
+    if (effect != NULL && effect->step_function == operator->step_function){ // built-in, not a custom operator with the same name
+        rebx_check_effect_params(rebx, effect, operator->ap);
+    }
+
     struct reb_simulation* const sim = rebx->sim;
     double dt_fraction;
     if (operator->operator_type == REBX_OPERATOR_RECORDER){
@@ -612,54 +870,146 @@ int rebx_add_operator(struct rebx_extras* rebx, struct rebx_operator* operator){
  User interface for setting parameter values
  *****************************************************************/
 
+/* Parameters attached to particles, forces and operators live in a single allocation holding the list node,
+ * the rebx_param and (for fixed-size types) the value itself. The name points to the registered parameter's name.
+ * ap stays a plain rebx_node list, so the Python side and the binary format are unaffected.
+ * On 64-bit platforms the node and param take 48 bytes, so a double parameter fits a 64-byte pool slot. */
+struct rebx_param_record{
+    struct rebx_node node;
+    struct rebx_param param;
+    double value[];             // inline value storage (double for alignment)
+};
+
+size_t rebx_param_value_size(enum rebx_param_type type){
+    switch(type){
+        case REBX_TYPE_DOUBLE:
+            return sizeof(double);
+        case REBX_TYPE_INT:
+            return sizeof(int);
+        case REBX_TYPE_UINT32:
+            return sizeof(uint32_t);
+        case REBX_TYPE_VEC3D:
+            return sizeof(struct reb_vec3d);
+        case REBX_TYPE_ORBIT:
+            return sizeof(struct reb_orbit);
+        default:                // values stored by reference
+            return 0;
+    }
+}
+
+static size_t rebx_param_record_size(enum rebx_param_type type){
+    return sizeof(struct rebx_param_record) + rebx_param_value_size(type);
+}
+
+struct rebx_param* rebx_add_param_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key){
+    const struct rebx_param* const reg_param = rebx_get_registered_param(rebx, key);
+    const size_t value_size = rebx_param_value_size(reg_param->type);
+    if (rebx->pool == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Parameter pool not initialized.\n");
+        return NULL;
+    }
+    struct rebx_param_record* record = rebx_pool_alloc(rebx->pool, rebx_param_record_size(reg_param->type));
+    if (record == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for parameter.\n");
+        return NULL;
+    }
+    struct rebx_param* param = &record->param;
+    param->name = reg_param->name;
+    param->type = reg_param->type;
+    param->key = key;
+    param->length = 0;
+    param->pooled = 1;
+    param->value = value_size ? record->value : NULL;
+    record->node.object = param;
+    rebx_add_node(apptr, &record->node);
+    rebx->param_generation++;
+    return param;
+}
+
 // Gets parameter if it already exists, otherwise creates a new one and adds it to the passed linked list
-struct rebx_param* rebx_get_or_add_param(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name){
+struct rebx_param* rebx_get_or_add_param_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key){
     if (apptr == NULL){
         rebx_error(rebx, "REBOUNDx Error: Passed NULL apptr to rebx_add_param. See examples.\n");
         return NULL;
     }
+    if (key < 0 || key >= rebx->N_param_keys){
+        rebx_error(rebx, "REBOUNDx Error: Invalid parameter key. Keys must be obtained from rebx_register_param or rebx_get_param_key.\n");
+        return NULL;
+    }
 
     // Check whether it already exists in linked list
-    struct rebx_param* param = rebx_get_param_struct(rebx, *apptr, param_name);
+    struct rebx_param* param = rebx_get_param_struct_by_key(rebx, *apptr, key);
 
     if(param == NULL){
-        enum rebx_param_type type = rebx_get_type(rebx, param_name);
-        if (type == REBX_TYPE_NONE){
-            char str[300];
-            sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);
-            rebx_error(rebx, str);
-            return NULL;
-        }
-        param = rebx_create_param(rebx, param_name, type);
-        if (param == NULL){ // adding new param failed
-            return NULL;
-        }
-        int success = rebx_add_param(rebx, apptr, param);
-        if(!success){
-            rebx_free_param(param);
-            return NULL;
-        }
+        param = rebx_add_param_by_key(rebx, apptr, key);
+    }
+    return param;
+}
+
+struct rebx_param* rebx_get_or_add_param(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name){
+    const int key = rebx_get_param_key(rebx, param_name);
+    if (key < 0){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);
+        rebx_error(rebx, str);
+        return NULL;
+    }
+    return rebx_get_or_add_param_by_key(rebx, apptr, key);
+}
+
+// Values of fixed-size types live inline in the param record, so setters just write through
+static struct rebx_param* rebx_get_or_add_typed_param(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, enum rebx_param_type type){
+    struct rebx_param* param = rebx_get_or_add_param_by_key(rebx, apptr, key);
+    if (param == NULL){
+        return NULL;
+    }
+    if (param->type != type || param->value == NULL){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Parameter '%s' was registered with a different type.\n", param->name);
+        rebx_error(rebx, str);
+        return NULL;
     }
     return param;
 }
 
-void rebx_set_param_pointer(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, void* val){
-    struct rebx_param* param = rebx_get_or_add_param(rebx, apptr, param_name);
+// Index of param's binding in rebx->interpolated_params, or -1 if it is not bound to an interpolator
+static int rebx_find_interpolated_param(const struct rebx_extras* const rebx, const struct rebx_param* const param){
+    for (int i=0; i<rebx->N_interpolated_params; i++){
+        if (rebx->interpolated_params[i].param == param){
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Drops param's binding (if any) from the list of interpolated params and frees its interpolator
+static void rebx_unbind_interpolator(struct rebx_extras* const rebx, struct rebx_param* const param){
+    const int i = rebx_find_interpolated_param(rebx, param);
+    if (i < 0){
+        return;
+    }
+    rebx_free_interpolator(rebx->interpolated_params[i].interpolator);
+    rebx->interpolated_params[i] = rebx->interpolated_params[--rebx->N_interpolated_params];
+}
+
+void rebx_set_param_pointer_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, void* val){
+    struct rebx_param* param = rebx_get_or_add_param_by_key(rebx, apptr, key);
     if (param == NULL){
         return;
     }
-    param->value = val;
+    if (param->value != val){
+        param->value = val;
+        rebx->param_generation++; // cached value pointers are stale
+    }
     return;
 }
 
-void rebx_set_param_double(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, double val){
-    struct rebx_param* param = rebx_get_or_add_param(rebx, apptr, param_name);
+void rebx_set_param_double_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, double val){
+    struct rebx_param* param = rebx_get_or_add_typed_param(rebx, apptr, key, REBX_TYPE_DOUBLE);
     if (param == NULL){
         return;
     }
-    if (param->value == NULL){ // new parameter, allocate
-        param->value = rebx_malloc(rebx, sizeof(double));
-    }
+    rebx_unbind_interpolator(rebx, param); // setting a value explicitly overrides any binding
     // Update new or existing param value
     double* valptr = param->value;
     *valptr = val;
@@ -667,14 +1017,11 @@ void rebx_set_param_double(struct rebx_extras* const rebx, struct rebx_node** ap
     return;
 }
 
-void rebx_set_param_int(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, int val){
-    struct rebx_param* param = rebx_get_or_add_param(rebx, apptr, param_name);
+void rebx_set_param_int_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, int val){
+    struct rebx_param* param = rebx_get_or_add_typed_param(rebx, apptr, key, REBX_TYPE_INT);
     if (param == NULL){
         return;
     }
-    if (param->value == NULL){ // new parameter, allocate
-        param->value = rebx_malloc(rebx, sizeof(int));
-    }
     // Update new or existing param value
     int* valptr = param->value;
     *valptr = val;
@@ -682,14 +1029,11 @@ void rebx_set_param_int(struct rebx_extras* const rebx, struct rebx_node** apptr
     return;
 }
 
-void rebx_set_param_uint32(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, uint32_t val){
-    struct rebx_param* param = rebx_get_or_add_param(rebx, apptr, param_name);
+void rebx_set_param_uint32_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, uint32_t val){
+    struct rebx_param* param = rebx_get_or_add_typed_param(rebx, apptr, key, REBX_TYPE_UINT32);
     if (param == NULL){
         return;
     }
-    if (param->value == NULL){ // new parameter, allocate
-        param->value = rebx_malloc(rebx, sizeof(uint32_t));
-    }
     // Update new or existing param value
     uint32_t* valptr = param->value;
     *valptr = val;
@@ -697,14 +1041,11 @@ void rebx_set_param_uint32(struct rebx_extras* const rebx, struct rebx_node** ap
     return;
 }
 
-void rebx_set_param_vec3d(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, struct reb_vec3d val){
-    struct rebx_param* param = rebx_get_or_add_param(rebx, apptr, param_name);
+void rebx_set_param_vec3d_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, struct reb_vec3d val){
+    struct rebx_param* param = rebx_get_or_add_typed_param(rebx, apptr, key, REBX_TYPE_VEC3D);
     if (param == NULL){
         return;
     }
-    if (param->value == NULL){ // new parameter, allocate
-        param->value = rebx_malloc(rebx, sizeof(struct reb_vec3d));
-    }
     // Update new or existing param value
     struct reb_vec3d* valptr = param->value;
     valptr->x = val.x;
@@ -714,78 +1055,512 @@ void rebx_set_param_vec3d(struct rebx_extras* const rebx, struct rebx_node** app
     return;
 }
 
-/*******************************************************************
- User interface for getting REBOUNDx objects and parameters
- *******************************************************************/
-
-struct rebx_param* rebx_get_param_struct(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name){
-    struct rebx_node* current = ap;
-    while(current != NULL){
-        struct rebx_param* param = current->object;
-        if(strcmp(param->name, param_name) == 0){
-            return param;
-        }
-        current = current->next;
+// Array values are always separately allocated (their length can change), and owned by the param
+static void rebx_set_param_array_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, enum rebx_param_type type, const void* const values, const int N){
+    if (N < 0){
+        rebx_error(rebx, "REBOUNDx Error: Array parameters can't have negative length.\n");
+        return;
     }
-
-    return NULL;   // name not found. Don't want warnings for optional parameters so don't reb_simulation_error
-}
-
-void* rebx_get_param(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name){
-    struct rebx_param* param = rebx_get_param_struct(rebx, ap, param_name);
+    struct rebx_param* param = rebx_get_or_add_param_by_key(rebx, apptr, key);
     if (param == NULL){
-        return NULL;
+        return;
     }
-    else{
-        return param->value;
+    if (param->type != type){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Parameter '%s' was registered with a different type.\n", param->name);
+        rebx_error(rebx, str);
+        return;
     }
-}
-
-struct rebx_force* rebx_get_force(struct rebx_extras* const rebx, const char* const name){
-    struct rebx_node* current = rebx->allocated_forces;
-    while(current != NULL){
-        struct rebx_force* force = current->object;
-        if(strcmp(force->name, name) == 0){
-            return force;
+    const size_t size = N*rebx_sizeof(rebx, type);
+    if (N != param->length){
+        void* value = NULL;
+        if (N > 0){
+            value = rebx_malloc(rebx, size);
+            if (value == NULL){
+                return;
+            }
         }
-        current = current->next;
+        free(param->value);
+        param->value = value;
+        param->length = N;
+        rebx->param_generation++; // cached value pointers are stale
+    }
+    if (N > 0){
+        memmove(param->value, values, size);
     }
-
-    return NULL;
 }
 
-struct rebx_operator* rebx_get_operator(struct rebx_extras* const rebx, const char* const name){
-    struct rebx_node* current = rebx->allocated_operators;
-    while(current != NULL){
-        struct rebx_operator* operator = current->object;
-        if(strcmp(operator->name, name) == 0){
-            return operator;
-        }
-        current = current->next;
-    }
+void rebx_set_param_array_double_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, const double* const values, const int N){
+    rebx_set_param_array_by_key(rebx, apptr, key, REBX_TYPE_DOUBLE_ARRAY, values, N);
+}
 
-    return NULL;
+void rebx_set_param_array_int_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, const int* const values, const int N){
+    rebx_set_param_array_by_key(rebx, apptr, key, REBX_TYPE_INT_ARRAY, values, N);
 }
 
-/*******************************************************************
- User interface for removing REBOUNDx objects
- *******************************************************************/
+// Name-based setters look up the interned key once and defer to the _by_key versions
+#define REBX_SET_PARAM_BY_NAME(typename, ctype) \
+void rebx_set_param_##typename(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, ctype val){\
+    const int key = rebx_get_param_key(rebx, param_name);\
+    if (key < 0){\
+        char str[300];\
+        sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);\
+        rebx_error(rebx, str);\
+        return;\
+    }\
+    rebx_set_param_##typename##_by_key(rebx, apptr, key, val);\
+}
 
-int rebx_remove_force(struct rebx_extras* rebx, struct rebx_force* force){
-    int allocated = rebx_remove_node(&rebx->allocated_forces, force);
-    if(allocated){
-        rebx_free_force(rebx, force);
-    }
-    // success only cares about removal from add_forces that affects sim
-    int success = rebx_remove_node(&rebx->additional_forces, force);
-    return success;
+REBX_SET_PARAM_BY_NAME(pointer, void*)
+REBX_SET_PARAM_BY_NAME(double, double)
+REBX_SET_PARAM_BY_NAME(int, int)
+REBX_SET_PARAM_BY_NAME(uint32, uint32_t)
+REBX_SET_PARAM_BY_NAME(vec3d, struct reb_vec3d)
+
+#define REBX_SET_PARAM_ARRAY_BY_NAME(typename, ctype) \
+void rebx_set_param_array_##typename(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, const ctype* const values, const int N){\
+    const int key = rebx_get_param_key(rebx, param_name);\
+    if (key < 0){\
+        char str[300];\
+        sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);\
+        rebx_error(rebx, str);\
+        return;\
+    }\
+    rebx_set_param_array_##typename##_by_key(rebx, apptr, key, values, N);\
 }
 
-// Remove all steps in head pointer that have the passed operator in them.
-// Success = 1 if at least one removed. Need separate logic since operator
-// is nested inside step
-static int rebx_remove_step_node(struct rebx_node** head, struct rebx_operator* operator){
-    if (*head == NULL){
+REBX_SET_PARAM_ARRAY_BY_NAME(double, double)
+REBX_SET_PARAM_ARRAY_BY_NAME(int, int)
+
+// Binds param to interpolator, taking ownership of it (it is freed if the binding fails)
+static int rebx_bind_interpolator(struct rebx_extras* const rebx, struct rebx_param* const param, struct rebx_interpolator* const interpolator){
+    if (interpolator == NULL){
+        return 0;
+    }
+    if (rebx->N_interpolated_params == rebx->N_allocated_interpolated_params){
+        const int N_allocated = rebx->N_allocated_interpolated_params ? 2*rebx->N_allocated_interpolated_params : 8;
+        struct rebx_interpolated_param* interpolated_params = realloc(rebx->interpolated_params, N_allocated*sizeof(*interpolated_params));
+        if (interpolated_params == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for interpolated parameters.\n");
+            rebx_free_interpolator(interpolator);
+            return 0;
+        }
+        rebx->interpolated_params = interpolated_params;
+        rebx->N_allocated_interpolated_params = N_allocated;
+    }
+    rebx->interpolated_params[rebx->N_interpolated_params++] = (struct rebx_interpolated_param){.param = param, .interpolator = interpolator};
+    *(double*)param->value = rebx_interpolate(rebx, interpolator, rebx->sim->t);
+    return 1;
+}
+
+int rebx_set_param_interpolator(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, const struct rebx_interpolator* const interpolator){
+    const int key = rebx_get_param_key(rebx, param_name);
+    if (key < 0){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);
+        rebx_error(rebx, str);
+        return 0;
+    }
+    struct rebx_param* param = rebx_get_or_add_typed_param(rebx, apptr, key, REBX_TYPE_DOUBLE);
+    if (param == NULL){
+        return 0;
+    }
+    rebx_unbind_interpolator(rebx, param);
+    if (interpolator == NULL){
+        return 1;
+    }
+    return rebx_bind_interpolator(rebx, param, rebx_create_interpolator(rebx, interpolator->Nvalues, interpolator->times, interpolator->values, interpolator->interpolation));
+}
+
+// Shared checks for the bulk particle parameter functions. Returns the key, or -1 (after raising an error)
+static int rebx_particle_array_key(struct rebx_extras* const rebx, const char* const param_name, const int start, const int* const indices, const int N){
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return -1;
+    }
+    const int key = rebx_get_param_key(rebx, param_name);
+    if (key < 0){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Need to register parameter name '%s' before using it. See examples.\n", param_name);
+        rebx_error(rebx, str);
+        return -1;
+    }
+    if (rebx_get_registered_param(rebx, key)->type != REBX_TYPE_DOUBLE){
+        char str[300];
+        sprintf(str, "REBOUNDx Error: Parameter '%s' is not of type REBX_TYPE_DOUBLE.\n", param_name);
+        rebx_error(rebx, str);
+        return -1;
+    }
+    const int N_particles = rebx->sim->N;
+    if (indices == NULL){
+        if (N < 0 || start < 0 || start + N > N_particles){
+            rebx_error(rebx, "REBOUNDx Error: Particle range out of bounds.\n");
+            return -1;
+        }
+        return key;
+    }
+    for (int i=0; i<N; i++){
+        if (indices[i] < 0 || indices[i] >= N_particles){
+            rebx_error(rebx, "REBOUNDx Error: Particle index out of bounds.\n");
+            return -1;
+        }
+    }
+    return key;
+}
+
+int rebx_set_particles_param_double(struct rebx_extras* const rebx, const char* const param_name, const int start, const int* const indices, const int N, const double* const values){
+    const int key = rebx_particle_array_key(rebx, param_name, start, indices, N);
+    if (key < 0){
+        return 0;
+    }
+    struct reb_particle* const particles = rebx->sim->particles;
+    for (int i=0; i<N; i++){
+        struct reb_particle* const p = &particles[indices ? indices[i] : start + i];
+        struct rebx_param* const param = rebx_get_or_add_typed_param(rebx, (struct rebx_node**)&p->ap, key, REBX_TYPE_DOUBLE);
+        if (param == NULL){
+            return 0;
+        }
+        rebx_unbind_interpolator(rebx, param);
+        *(double*)param->value = values[i];
+    }
+    return 1;
+}
+
+int rebx_get_particles_param_double(struct rebx_extras* const rebx, const char* const param_name, const int start, const int* const indices, const int N, double* const values){
+    const int key = rebx_particle_array_key(rebx, param_name, start, indices, N);
+    if (key < 0){
+        return -1;
+    }
+    struct reb_particle* const particles = rebx->sim->particles;
+    int N_found = 0;
+    for (int i=0; i<N; i++){
+        const struct reb_particle* const p = &particles[indices ? indices[i] : start + i];
+        const double* const value = rebx_get_param_by_key(rebx, p->ap, key);
+        if (value == NULL){
+            values[i] = NAN;
+            continue;
+        }
+        values[i] = *value;
+        N_found++;
+    }
+    return N_found;
+}
+
+/*******************************************************************
+ User interface for getting REBOUNDx objects and parameters
+ *******************************************************************/
+
+// Resolves the name through the hash index and compares keys. Only params without a key (loaded from a binary under a name
+// that is not registered, or with a different type) are compared by name.
+struct rebx_param* rebx_get_param_struct(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name){
+    const int key = rebx_get_param_key(rebx, param_name);
+    struct rebx_node* current = ap;
+    while(current != NULL){
+        struct rebx_param* param = current->object;
+        if(param->key >= 0 ? param->key == key : strcmp(param->name, param_name) == 0){
+            return param;
+        }
+        current = current->next;
+    }
+
+    return NULL;   // name not found. Don't want warnings for optional parameters so don't reb_simulation_error
+}
+
+struct rebx_param* rebx_get_param_struct_by_key(struct rebx_extras* const rebx, struct rebx_node* ap, const int key){
+    struct rebx_node* current = ap;
+    while(current != NULL){
+        struct rebx_param* param = current->object;
+        if(param->key == key){
+            return param;
+        }
+        current = current->next;
+    }
+
+    return NULL;
+}
+
+void* rebx_get_param_by_key(struct rebx_extras* const rebx, struct rebx_node* ap, const int key){
+    struct rebx_param* param = rebx_get_param_struct_by_key(rebx, ap, key);
+    if (param == NULL){
+        return NULL;
+    }
+    else{
+        return param->value;
+    }
+}
+
+void* rebx_get_param(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name){
+    struct rebx_param* param = rebx_get_param_struct(rebx, ap, param_name);
+    if (param == NULL){
+        return NULL;
+    }
+    else{
+        return param->value;
+    }
+}
+
+int rebx_get_param_length(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name){
+    struct rebx_param* param = rebx_get_param_struct(rebx, ap, param_name);
+    if (param == NULL){
+        return 0;
+    }
+    if (param->type == REBX_TYPE_DOUBLE_ARRAY || param->type == REBX_TYPE_INT_ARRAY){
+        return param->length;
+    }
+    return 1;
+}
+
+/*******************************************************************
+ Compiled participant lists
+ *******************************************************************/
+
+static int rebx_participants_valid(const struct rebx_extras* const rebx, const struct rebx_participants* const list, const struct reb_particle* const particles, const int N){
+    if (list->generation != rebx->param_generation || list->N_particles != N){
+        return 0;
+    }
+    // Particles can be removed and added (or reordered) without changing N. Participants always have a non-NULL ap, so checking these is enough.
+    for (int j=0; j<list->N; j++){
+        if (particles[list->indices[j]].ap != list->aps[j]){
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int rebx_build_participants(struct rebx_extras* const rebx, struct rebx_participants* const list, struct reb_particle* const particles, const int N){
+    const int N_keys = list->N_keys;
+    list->N = 0;
+    for (int i=0; i<N; i++){
+        struct rebx_node* ap = particles[i].ap;
+        if (ap == NULL){
+            continue;
+        }
+        void* vals[REBX_PARTICIPANTS_MAX_KEYS];
+        int found = 0;
+        for (int k=0; k<N_keys; k++){
+            vals[k] = rebx_get_param_by_key(rebx, ap, list->keys[k]);
+            if (vals[k] != NULL){
+                found = 1;
+            }
+        }
+        if (!found){
+            continue;
+        }
+        if (list->N == list->N_allocated){
+            const int N_allocated = list->N_allocated ? 2*list->N_allocated : 16;
+            int* indices = realloc(list->indices, N_allocated*sizeof(*indices));
+            struct rebx_node** aps = realloc(list->aps, N_allocated*sizeof(*aps));
+            void** values = realloc(list->values, N_allocated*N_keys*sizeof(*values));
+            if (indices) list->indices = indices;
+            if (aps) list->aps = aps;
+            if (values) list->values = values;
+            if (indices == NULL || aps == NULL || values == NULL){
+                rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for compiled participant list.\n");
+                list->N = 0;
+                return 0;
+            }
+            list->N_allocated = N_allocated;
+        }
+        list->indices[list->N] = i;
+        list->aps[list->N] = ap;
+        for (int k=0; k<N_keys; k++){
+            list->values[list->N*N_keys + k] = vals[k];
+        }
+        list->N++;
+    }
+    list->generation = rebx->param_generation;
+    list->N_particles = N;
+    return 1;
+}
+
+const struct rebx_participants* rebx_get_participants(struct rebx_extras* const rebx, struct rebx_force* const force, struct reb_particle* const particles, const int N, const int N_keys, const int* const keys){
+    if (N_keys < 1 || N_keys > REBX_PARTICIPANTS_MAX_KEYS){
+        rebx_error(rebx, "REBOUNDx Error: Number of keys passed to rebx_get_participants must be between 1 and REBX_PARTICIPANTS_MAX_KEYS.\n");
+        return NULL;
+    }
+    struct rebx_participants* list = force->participants;
+    while (list != NULL){
+        if (list->N_keys == N_keys && memcmp(list->keys, keys, N_keys*sizeof(*keys)) == 0){
+            break;
+        }
+        list = list->next;
+    }
+    if (list == NULL){
+        list = calloc(1, sizeof(*list));
+        if (list == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for compiled participant list.\n");
+            return NULL;
+        }
+        list->N_keys = N_keys;
+        memcpy(list->keys, keys, N_keys*sizeof(*keys));
+        list->N_particles = -1; // force a build
+        list->next = force->participants;
+        force->participants = list;
+    }
+    if (!rebx_participants_valid(rebx, list, particles, N)){
+        if (!rebx_build_participants(rebx, list, particles, N)){
+            return NULL;
+        }
+    }
+    return list;
+}
+
+void rebx_free_participants(struct rebx_participants* list){
+    while (list != NULL){
+        struct rebx_participants* next = list->next;
+        free(list->indices);
+        free(list->aps);
+        free(list->values);
+        free(list);
+        list = next;
+    }
+}
+
+/*******************************************************************
+ Acceleration buffers for parallel kernels
+ *******************************************************************/
+
+static int rebx_max_threads(void){
+#ifdef OPENMP
+    return omp_get_max_threads();
+#else
+    return 1;
+#endif
+}
+
+struct rebx_acc_buffers* rebx_get_acc_buffers(struct rebx_extras* const rebx, struct rebx_force* const force, const int N_slots, const int N){
+    struct rebx_acc_buffers* buffers = force->acc_buffers;
+    if (buffers == NULL){
+        buffers = calloc(1, sizeof(*buffers));
+        if (buffers == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for acceleration buffers.\n");
+            return NULL;
+        }
+        force->acc_buffers = buffers;
+    }
+    int N_blocks;
+    if (rebx->deterministic_reductions){ // partition only depends on N
+        buffers->block_size = REBX_DETERMINISTIC_BLOCK_SIZE;
+        N_blocks = (N + REBX_DETERMINISTIC_BLOCK_SIZE - 1)/REBX_DETERMINISTIC_BLOCK_SIZE;
+    }
+    else{ // one block per thread
+        N_blocks = N >= REBX_OMP_MIN_N ? rebx_max_threads() : 1;
+        buffers->block_size = (N + N_blocks - 1)/N_blocks;
+    }
+    if (N_blocks < 1){
+        N_blocks = 1;
+    }
+    const int stride = (3*N_slots + 7) & ~7; // 8 doubles = 64 byte cache line
+    const size_t size = (size_t)N_blocks*stride;
+    if (size > buffers->N_allocated){
+        double* acc = realloc(buffers->acc, size*sizeof(*acc));
+        if (acc == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for acceleration buffers.\n");
+            return NULL;
+        }
+        buffers->acc = acc;
+        buffers->N_allocated = size;
+    }
+    buffers->N_slots = N_slots;
+    buffers->stride = stride;
+    buffers->N = N;
+    buffers->N_blocks = N_blocks;
+    memset(buffers->acc, 0, size*sizeof(*buffers->acc));
+    return buffers;
+}
+
+double* rebx_block_acc(struct rebx_acc_buffers* const buffers, const int block, int* const start, int* const end){
+    *start = block*buffers->block_size;
+    *end = *start + buffers->block_size < buffers->N ? *start + buffers->block_size : buffers->N;
+    return buffers->acc + (size_t)block*buffers->stride;
+}
+
+void rebx_reduce_acc_buffers(struct rebx_acc_buffers* const buffers, struct reb_particle* const particles, const int* const indices){
+    // Pairwise sum of the blocks in a fixed order, so the result only depends on the partition
+    const int n = 3*buffers->N_slots;
+    for (int width=1; width<buffers->N_blocks; width*=2){
+        for (int b=0; b+width<buffers->N_blocks; b+=2*width){
+            double* const dst = buffers->acc + (size_t)b*buffers->stride;
+            const double* const src = buffers->acc + (size_t)(b+width)*buffers->stride;
+            for (int k=0; k<n; k++){
+                dst[k] += src[k];
+            }
+        }
+    }
+    for (int s=0; s<buffers->N_slots; s++){
+        struct reb_particle* const p = &particles[indices ? indices[s] : s];
+        p->ax += buffers->acc[3*s];
+        p->ay += buffers->acc[3*s+1];
+        p->az += buffers->acc[3*s+2];
+    }
+}
+
+void* rebx_get_workspace(struct rebx_extras* const rebx, struct rebx_force* const force, const size_t size){
+    if (size > force->workspace_size){
+        void* workspace = realloc(force->workspace, size);
+        if (workspace == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory for force workspace.\n");
+            return NULL;
+        }
+        force->workspace = workspace;
+        force->workspace_size = size;
+    }
+    return force->workspace;
+}
+
+void rebx_free_acc_buffers(struct rebx_acc_buffers* buffers){
+    if (buffers != NULL){
+        free(buffers->acc);
+        free(buffers);
+    }
+}
+
+struct rebx_force* rebx_get_force(struct rebx_extras* const rebx, const char* const name){
+    struct rebx_node* current = rebx->allocated_forces;
+    while(current != NULL){
+        struct rebx_force* force = current->object;
+        if(strcmp(force->name, name) == 0){
+            return force;
+        }
+        current = current->next;
+    }
+
+    return NULL;
+}
+
+struct rebx_operator* rebx_get_operator(struct rebx_extras* const rebx, const char* const name){
+    struct rebx_node* current = rebx->allocated_operators;
+    while(current != NULL){
+        struct rebx_operator* operator = current->object;
+        if(strcmp(operator->name, name) == 0){
+            return operator;
+        }
+        current = current->next;
+    }
+
+    return NULL;
+}
+
+/*******************************************************************
+ User interface for removing REBOUNDx objects
+ *******************************************************************/
+
+int rebx_remove_force(struct rebx_extras* rebx, struct rebx_force* force){
+    int allocated = rebx_remove_node(&rebx->allocated_forces, force);
+    if(allocated){
+        rebx_free_force(rebx, force);
+    }
+    // success only cares about removal from add_forces that affects sim
+    int success = rebx_remove_node(&rebx->additional_forces, force);
+    rebx_invalidate_plan(rebx);
+    return success;
+}
+
+// Remove all steps in head pointer that have the passed operator in them.
+// Success = 1 if at least one removed. Need separate logic since operator
+// is nested inside step
+static int rebx_remove_step_node(struct rebx_node** head, struct rebx_operator* operator){
+    if (*head == NULL){
         return 0;
     }
 
@@ -817,9 +1592,10 @@ static int rebx_remove_step_node(struct rebx_node** head, struct rebx_operator*
 int rebx_remove_operator(struct rebx_extras* rebx, struct rebx_operator* operator){
     int allocated = rebx_remove_node(&rebx->allocated_operators, operator);
     if(allocated){
-        rebx_free_operator(operator);
+        rebx_free_operator(rebx, operator);
 
     }
+    rebx_invalidate_plan(rebx);
 
     // success only cares about removal from lists that actually do
     // something to sim below. Success if EITHER one successful.
@@ -843,6 +1619,263 @@ int rebx_remove_operator(struct rebx_extras* rebx, struct rebx_operator* operato
     return success;
 }
 
+/*******************************************************************
+ Copying REBOUNDx instances
+ *******************************************************************/
+
+// Forces (and operators) of the source instance and their copies, at the same index
+struct rebx_copy_map{
+    void** src;
+    void** dst;
+    int N;
+};
+
+static void* rebx_copy_map_lookup(const struct rebx_copy_map* const map, const void* const object){
+    for (int i=0; i<map->N; i++){
+        if (map->src[i] == object){
+            return map->dst[i];
+        }
+    }
+    return NULL;
+}
+
+// Copies a param that is not registered (e.g. loaded from a binary with an unknown name). Stored as a separate allocation like in input.c
+static int rebx_copy_unregistered_param(struct rebx_extras* const rebx_dst, struct rebx_node** apptr, const struct rebx_param* const src_param, const struct rebx_copy_map* const forces){
+    size_t size = rebx_param_value_size(src_param->type);
+    if (src_param->type == REBX_TYPE_DOUBLE_ARRAY || src_param->type == REBX_TYPE_INT_ARRAY){
+        size = src_param->length*rebx_sizeof(rebx_dst, src_param->type);
+    }
+    else if (src_param->type != REBX_TYPE_FORCE && size == 0){ // can't know what pointers and ODEs refer to
+        return 1;
+    }
+    struct rebx_param* param = rebx_create_param(rebx_dst, src_param->name, src_param->type);
+    if (param == NULL){
+        return 0;
+    }
+    param->length = src_param->length;
+    if (src_param->type == REBX_TYPE_FORCE){
+        void* const force = rebx_copy_map_lookup(forces, src_param->value);
+        param->value = force ? force : src_param->value;
+    }
+    else if (size > 0){
+        param->value = rebx_malloc(rebx_dst, size);
+        if (param->value == NULL){
+            rebx_free_param(param);
+            return 0;
+        }
+        memcpy(param->value, src_param->value, size);
+    }
+    if (!rebx_add_param(rebx_dst, apptr, param)){
+        rebx_free_param(param);
+        return 0;
+    }
+    return 1;
+}
+
+// Copies all params in src_ap onto *apptr. Force params are pointed at the copied forces. Scratch arrays set by integrate_force
+// and ODEs belong to the source simulation, so they are not copied (integrate_force reallocates its arrays when they are missing).
+static int rebx_copy_ap(struct rebx_extras* const rebx_dst, const struct rebx_extras* const rebx_src, struct rebx_node** apptr, struct rebx_node* src_ap, const struct rebx_copy_map* const forces){
+    for (struct rebx_node* current = src_ap; current != NULL; current = current->next){
+        const struct rebx_param* const src_param = current->object;
+        if (src_param->key < 0){
+            if (!rebx_copy_unregistered_param(rebx_dst, apptr, src_param, forces)){
+                return 0;
+            }
+            continue;
+        }
+        const int key = rebx_get_param_key(rebx_dst, src_param->name);
+        switch (src_param->type){
+            case REBX_TYPE_DOUBLE:
+            case REBX_TYPE_INT:
+            case REBX_TYPE_UINT32:
+            case REBX_TYPE_VEC3D:
+            case REBX_TYPE_ORBIT:
+            {
+                struct rebx_param* const param = rebx_get_or_add_param_by_key(rebx_dst, apptr, key);
+                if (param == NULL){
+                    return 0;
+                }
+                memcpy(param->value, src_param->value, rebx_param_value_size(src_param->type));
+                // Interpolation tables are shared with the source rather than duplicated
+                const int i = rebx_find_interpolated_param(rebx_src, src_param);
+                if (i >= 0 && !rebx_bind_interpolator(rebx_dst, param, rebx_share_interpolator(rebx_dst, rebx_src->interpolated_params[i].interpolator))){
+                    return 0;
+                }
+                break;
+            }
+            case REBX_TYPE_DOUBLE_ARRAY:
+            case REBX_TYPE_INT_ARRAY:
+                rebx_set_param_array_by_key(rebx_dst, apptr, key, src_param->type, src_param->value, src_param->length);
+                break;
+            case REBX_TYPE_FORCE:
+            {
+                void* const force = rebx_copy_map_lookup(forces, src_param->value);
+                rebx_set_param_pointer_by_key(rebx_dst, apptr, key, force ? force : src_param->value);
+                break;
+            }
+            case REBX_TYPE_POINTER:
+                if (!rebx_name_in_list(rebx_integrated_force_params, src_param->name)){ // user pointers are shared
+                    rebx_set_param_pointer_by_key(rebx_dst, apptr, key, src_param->value);
+                }
+                break;
+            default:
+                break;
+        }
+    }
+    return 1;
+}
+
+// Appends copies of the nodes in src_list to *dst_list, keeping their order. Objects are mapped through map, or are steps whose operators are
+static int rebx_copy_list(struct rebx_extras* const rebx_dst, struct rebx_node** dst_list, struct rebx_node* src_list, const struct rebx_copy_map* const map, const int steps){
+    struct rebx_node** tail = dst_list;
+    while (*tail != NULL){
+        tail = &(*tail)->next;
+    }
+    for (struct rebx_node* current = src_list; current != NULL; current = current->next){
+        void* object;
+        if (steps){
+            const struct rebx_step* const src_step = current->object;
+            struct rebx_step* const step = rebx_malloc(rebx_dst, sizeof(*step));
+            if (step == NULL){
+                return 0;
+            }
+            step->operator = rebx_copy_map_lookup(map, src_step->operator);
+            step->dt_fraction = src_step->dt_fraction;
+            object = step;
+        }
+        else{
+            object = rebx_copy_map_lookup(map, current->object);
+        }
+        struct rebx_node* const node = rebx_create_node(rebx_dst);
+        if (node == NULL){
+            if (steps){
+                free(object);
+            }
+            return 0;
+        }
+        node->object = object;
+        *tail = node;
+        tail = &node->next;
+    }
+    return 1;
+}
+
+int rebx_copy_extras(struct rebx_extras* const rebx_dst, struct rebx_extras* const rebx_src){
+    if (rebx_dst->sim == NULL || rebx_src->sim == NULL){
+        rebx_error(rebx_dst, ""); // rebx_error gives meaningful err
+        return 0;
+    }
+    struct reb_simulation* const sim_dst = rebx_dst->sim;
+    struct reb_simulation* const sim_src = rebx_src->sim;
+    if (sim_dst->N != sim_src->N){
+        rebx_error(rebx_dst, "REBOUNDx Error: Can only copy REBOUNDx to a simulation with the same number of particles.\n");
+        return 0;
+    }
+
+    // Registered params, in key order
+    for (int key=REBX_N_DEFAULT_PARAMS; key<rebx_src->N_param_keys; key++){
+        const struct rebx_param* const reg_param = rebx_get_registered_param(rebx_src, key);
+        const enum rebx_param_type type = rebx_get_type(rebx_dst, reg_param->name);
+        if (type == REBX_TYPE_NONE){
+            if (rebx_register_param(rebx_dst, reg_param->name, reg_param->type) < 0){
+                return 0;
+            }
+        }
+        else if (type != reg_param->type){
+            char str[300];
+            sprintf(str, "REBOUNDx Error: Parameter '%s' is registered with a different type in the destination.\n", reg_param->name);
+            rebx_error(rebx_dst, str);
+            return 0;
+        }
+    }
+
+    // Forces and operators. Created back to front so allocated_forces and allocated_operators keep their order
+    const int N_forces = rebx_len(rebx_src->allocated_forces);
+    const int N_operators = rebx_len(rebx_src->allocated_operators);
+    struct rebx_copy_map forces = {.src = malloc(2*N_forces*sizeof(void*)), .N = 0};
+    struct rebx_copy_map operators = {.src = malloc(2*N_operators*sizeof(void*)), .N = 0};
+    forces.dst = forces.src + N_forces;
+    operators.dst = operators.src + N_operators;
+    int success = (forces.src != NULL || N_forces == 0) && (operators.src != NULL || N_operators == 0);
+    if (!success){
+        rebx_error(rebx_dst, "REBOUNDx Error: Could not allocate memory.\n");
+    }
+    int i = N_forces;
+    for (struct rebx_node* current = rebx_src->allocated_forces; success && current != NULL; current = current->next){
+        forces.src[--i] = current->object;
+    }
+    for (i=0; success && i<N_forces; i++){
+        const struct rebx_force* const src_force = forces.src[i];
+        struct rebx_force* const force = rebx_create_force(rebx_dst, src_force->name);
+        if (force == NULL){
+            success = 0;
+            break;
+        }
+        force->force_type = src_force->force_type;
+        force->update_accelerations = src_force->update_accelerations;
+        forces.dst[forces.N++] = force;
+    }
+    i = N_operators;
+    for (struct rebx_node* current = rebx_src->allocated_operators; success && current != NULL; current = current->next){
+        operators.src[--i] = current->object;
+    }
+    for (i=0; success && i<N_operators; i++){
+        const struct rebx_operator* const src_operator = operators.src[i];
+        struct rebx_operator* const operator = rebx_create_operator(rebx_dst, src_operator->name);
+        if (operator == NULL){
+            success = 0;
+            break;
+        }
+        operator->operator_type = src_operator->operator_type;
+        operator->step_function = src_operator->step_function;
+        operators.dst[operators.N++] = operator;
+    }
+
+    // Params, once all forces exist so force params can be rewired
+    for (i=0; success && i<N_forces; i++){
+        success = rebx_copy_ap(rebx_dst, rebx_src, &((struct rebx_force*)forces.dst[i])->ap, ((struct rebx_force*)forces.src[i])->ap, &forces);
+    }
+    for (i=0; success && i<N_operators; i++){
+        success = rebx_copy_ap(rebx_dst, rebx_src, &((struct rebx_operator*)operators.dst[i])->ap, ((struct rebx_operator*)operators.src[i])->ap, &forces);
+    }
+    for (i=0; success && i<sim_src->N; i++){
+        success = rebx_copy_ap(rebx_dst, rebx_src, (struct rebx_node**)&sim_dst->particles[i].ap, sim_src->particles[i].ap, &forces);
+    }
+
+    // Effects added to the simulation
+    success = success && rebx_copy_list(rebx_dst, &rebx_dst->additional_forces, rebx_src->additional_forces, &forces, 0);
+    success = success && rebx_copy_list(rebx_dst, &rebx_dst->pre_timestep_modifications, rebx_src->pre_timestep_modifications, &operators, 1);
+    success = success && rebx_copy_list(rebx_dst, &rebx_dst->post_timestep_modifications, rebx_src->post_timestep_modifications, &operators, 1);
+    rebx_invalidate_plan(rebx_dst);
+    if (success){
+        if (rebx_dst->additional_forces != NULL){
+            sim_dst->additional_forces = rebx_additional_forces;
+            for (struct rebx_node* current = rebx_dst->additional_forces; current != NULL; current = current->next){
+                if (((struct rebx_force*)current->object)->force_type == REBX_FORCE_VEL){
+                    sim_dst->force_is_velocity_dependent = 1;
+                }
+            }
+        }
+        if (rebx_dst->pre_timestep_modifications != NULL){
+            sim_dst->pre_timestep_modifications = rebx_pre_timestep_modifications;
+        }
+        if (rebx_dst->post_timestep_modifications != NULL){
+            sim_dst->post_timestep_modifications = rebx_post_timestep_modifications;
+        }
+        // ODEs are attached to the source simulation. Recreate them on the destination
+        for (i=0; i<N_forces; i++){
+            if (rebx_get_param(rebx_src, ((struct rebx_force*)forces.src[i])->ap, "ode") != NULL){
+                rebx_spin_initialize_ode(rebx_dst, forces.dst[i]);
+            }
+        }
+        rebx_dst->parallel_forces = rebx_src->parallel_forces;
+        rebx_dst->deterministic_reductions = rebx_src->deterministic_reductions;
+    }
+    free(forces.src);
+    free(operators.src);
+    return success;
+}
+
 /***************************************************************
  * Internal Memory Handling Routines
  ******************************************************************/
@@ -857,32 +1890,67 @@ void* rebx_malloc(struct rebx_extras* const rebx, size_t memsize){
     return ptr;
 }
 
+// Destructor for values REBOUNDx allocated separately from the param (only params that are not pooled records, e.g. loaded from a binary)
+static void rebx_free_param_value(struct rebx_param* param){
+    switch(param->type){
+        case REBX_TYPE_DOUBLE:
+        case REBX_TYPE_INT:
+        case REBX_TYPE_UINT32:
+        case REBX_TYPE_VEC3D:
+        case REBX_TYPE_ORBIT:
+        case REBX_TYPE_DOUBLE_ARRAY:
+        case REBX_TYPE_INT_ARRAY:
+            free(param->value);
+            break;
+        default:    // forces, ODEs and pointers are owned elsewhere
+            break;
+    }
+    param->value = NULL;
+}
+
 void rebx_free_param(struct rebx_param* param){
     if(param->name){
         free(param->name);
     }
-    // Don't free pointers to structs
-    if(param->type == REBX_TYPE_INT || param->type == REBX_TYPE_DOUBLE){
-        if(param->value){
-            free(param->value);
-        }
-    }
+    rebx_free_param_value(param);
     free(param);
 }
 
-void rebx_free_ap(struct rebx_node** ap){
+void rebx_free_ap(struct rebx_extras* rebx, struct rebx_node** ap){
     struct rebx_node* current = *ap;
     struct rebx_node* next;
     while (current != NULL){
         next = current->next;
-        rebx_free_param(current->object);
-        free(current);
+        if (rebx != NULL){
+            rebx_unbind_interpolator(rebx, current->object);
+        }
+        if (((struct rebx_param*)current->object)->pooled){ // value (if stored inline) goes with the record. Values set by pointer are owned by the caller
+            if (rebx != NULL){
+                struct rebx_param* const param = current->object;
+                if (param->type == REBX_TYPE_DOUBLE_ARRAY || param->type == REBX_TYPE_INT_ARRAY){
+                    rebx_free_param_value(param);
+                }
+                rebx_pool_free(rebx->pool, current, rebx_param_record_size(param->type));
+            } // otherwise freed in bulk with the pool
+        }
+        else{ // e.g. unregistered params loaded from a binary
+            rebx_free_param(current->object);
+            free(current);
+        }
         current = next;
     }
+    *ap = NULL;
 }
 
 void rebx_free_particle_ap(struct reb_particle* p){
-    rebx_free_ap((struct rebx_node **)(&p->ap));
+    struct rebx_extras* rebx = NULL;
+    if (p->sim != NULL && p->sim->extras != NULL){
+        rebx = p->sim->extras;
+        if (p->ap != NULL){
+            rebx->param_generation++;
+        }
+    }
+    rebx_free_ap(rebx, (struct rebx_node **)(&p->ap));
 }
 
 void rebx_free_force(struct rebx_extras* rebx, struct rebx_force* force){
@@ -893,15 +1961,18 @@ void rebx_free_force(struct rebx_extras* rebx, struct rebx_force* force){
     if(force->name){
         free(force->name);
     }
-    rebx_free_ap(&force->ap);
+    rebx_free_ap(rebx, &force->ap);
+    rebx_free_participants(force->participants);
+    rebx_free_acc_buffers(force->acc_buffers);
+    free(force->workspace);
     free(force);
 }
 
-void rebx_free_operator(struct rebx_operator* operator){
+void rebx_free_operator(struct rebx_extras* rebx, struct rebx_operator* operator){
     if(operator->name){
         free(operator->name);
     }
-    rebx_free_ap(&operator->ap);
+    rebx_free_ap(rebx, &operator->ap);
     free(operator);
 }
 
@@ -920,6 +1991,12 @@ void rebx_free_pointers(struct rebx_extras* rebx){
     if (rebx == NULL){
         return;
     }
+    struct reb_simulation* const sim = rebx->sim;
+    if (sim != NULL && sim->extras == rebx){ // particle params live in the pool
+        for (int i=0; i<sim->N; i++){
+            rebx_free_ap(rebx, (struct rebx_node**)&sim->particles[i].ap);
+        }
+    }
     rebx_detach(rebx->sim, rebx);
     struct rebx_node* current;
     struct rebx_node* next;
@@ -935,7 +2012,7 @@ void rebx_free_pointers(struct rebx_extras* rebx){
     current = rebx->allocated_operators;
     while (current != NULL){
         next = current->next;
-        rebx_free_operator(current->object);
+        rebx_free_operator(rebx, current->object);
         free(current);
         current = next;
     }
@@ -971,6 +2048,22 @@ void rebx_free_pointers(struct rebx_extras* rebx){
         free(current);
         current = next;
     }
+
+    free(rebx->param_keys);
+    rebx->param_keys = NULL;
+    free(rebx->param_index);
+    rebx->param_index = NULL;
+    rebx->N_allocated_param_index = 0;
+    rebx_free_plan(rebx->plan);
+    rebx->plan = NULL;
+    free(rebx->interpolated_params); // bindings were dropped with the params above
+    rebx->interpolated_params = NULL;
+    rebx->N_interpolated_params = 0;
+    rebx->N_allocated_interpolated_params = 0;
+    rebx_pool_destroy(rebx->pool);
+    rebx->pool = NULL;
+    rebx->N_param_keys = REBX_N_DEFAULT_PARAMS;
+    rebx->N_allocated_param_keys = 0;
 }
 
 /**********************************************
@@ -985,58 +2078,415 @@ void rebx_reset_accelerations(struct reb_particle* const ps, const int N){
     }
 }
 
-void rebx_additional_forces(struct reb_simulation* sim){
-    if(sim->N_var != 0){
-        reb_simulation_warning(sim, "REBOUNDx: Variational particles have been added to the simulation but are not implemented in REBOUNDx and will not be evolved self-consistently.");
+// Flattened copy of additional_forces and the pre/post timestep modifications, so the per-step dispatch is a plain loop.
+// The plan is invalidated whenever effects are added or removed, and is also rebuilt if any of the simulation settings
+// below change, since the warnings are only issued when the plan is built.
+struct rebx_plan_step{
+    struct rebx_operator* operator;
+    double dt_fraction;
+};
+
+struct rebx_plan{
+    int valid;
+    int integrator;                     // settings the plan was validated for
+    int N_var;
+    int force_is_velocity_dependent;
+    int ias15_adaptive;
+    int N_forces;
+    int N_pre;
+    int N_post;
+    struct rebx_force** forces;
+    struct rebx_plan_step* pre;
+    struct rebx_plan_step* post;
+    // Task-parallel evaluation (see rebx_extras.parallel_forces)
+    void (**independent)(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N); // for each force, its built-in function if it can run concurrently with the others, otherwise NULL
+    int N_independent;
+    struct reb_particle* task_particles;    // N_independent private copies of the particles array
+    size_t N_allocated_task_particles;
+    struct rebx_task_messages* task_messages;   // errors and warnings raised by each task, reported in plan order
+    int N_allocated_task_messages;
+    // Newtonian accelerations REBOUND computed before the additional forces (see rebx_get_gravity_acc)
+    int gravity_acc_users;                  // forces that can reuse them
+    int gravity_acc_valid;                  // set while the additional forces run, if the snapshot is complete
+    double* gravity_acc;                    // 3*N values
+    size_t N_allocated_gravity_acc;
+    // WHFast's Jacobi particles, while they describe the same state as the particles (see rebx_get_jacobi_particles)
+    int whfast_jacobi_current;              // set by steppers that just recalculated them from the particles
+    const struct reb_particle* jacobi_particles;
+};
+
+// Tasks can't write to the simulation's message log and status concurrently, so rebx_error and rebx_warning queue
+// messages raised inside a task on the task's list (found through the threadprivate pointer below) instead
+struct rebx_task_message{
+    int error;                          // 1 for an error, 0 for a warning
+    char* msg;
+    struct rebx_task_message* next;
+};
+
+struct rebx_task_messages{
+    struct rebx_task_message* first;
+    struct rebx_task_message* last;
+};
+
+static struct rebx_task_messages* rebx_current_task_messages = NULL;   // non-NULL while this thread runs a force task
+#pragma omp threadprivate(rebx_current_task_messages)
+
+static void rebx_queue_task_message(struct rebx_task_messages* const messages, const int error, const char* const msg){
+    struct rebx_task_message* const message = malloc(sizeof(*message));
+    char* const copy = malloc(strlen(msg) + 1);
+    if (message == NULL || copy == NULL){
+        free(message);
+        free(copy);
+        fprintf(stderr, "%s", msg);
+        return;
     }
-    struct rebx_extras* rebx = sim->extras;
-    struct rebx_node* current = rebx->additional_forces;
-    while(current != NULL){
-        if(sim->force_is_velocity_dependent && sim->integrator==REB_INTEGRATOR_WHFAST){
-            reb_simulation_warning(sim, "REBOUNDx: Passing a velocity-dependent force to WHFAST. Need to apply as an operator. See REBOUNDx paper sec 5.1.");
+    strcpy(copy, msg);
+    message->error = error;
+    message->msg = copy;
+    message->next = NULL;
+    if (messages->last != NULL){
+        messages->last->next = message;
+    }
+    else{
+        messages->first = message;
+    }
+    messages->last = message;
+}
+
+// Raises the queued messages on the simulation in the order they were raised and empties the list
+static void rebx_report_task_messages(struct reb_simulation* const sim, struct rebx_task_messages* const messages){
+    struct rebx_task_message* message = messages->first;
+    while (message != NULL){
+        struct rebx_task_message* const next = message->next;
+        if (message->error){
+            reb_simulation_error(sim, message->msg);
         }
-        struct rebx_force* force = current->object;
-        const double N = sim->N - sim->N_var;
-        force->update_accelerations(sim, force, sim->particles, N);
-        current = current->next;
+        else{
+            reb_simulation_warning(sim, message->msg);
+        }
+        free(message->msg);
+        free(message);
+        message = next;
     }
+    messages->first = NULL;
+    messages->last = NULL;
 }
 
-void rebx_pre_timestep_modifications(struct reb_simulation* sim){
-    if(sim->N_var != 0){
-        reb_simulation_warning(sim, "REBOUNDx: Variational particles have been added to the simulation but are not implemented in REBOUNDx and will not be evolved self-consistently.");
+void rebx_invalidate_plan(struct rebx_extras* const rebx){
+    if (rebx->plan != NULL){
+        rebx->plan->valid = 0;
     }
-    struct rebx_extras* rebx = sim->extras;
-    struct rebx_node* current = rebx->pre_timestep_modifications;
-    const double dt = sim->dt;
+}
 
-    while(current != NULL){
+void rebx_free_plan(struct rebx_plan* const plan){
+    if (plan == NULL){
+        return;
+    }
+    free(plan->forces);
+    free(plan->independent);
+    free(plan->task_particles);
+    free(plan->task_messages);
+    free(plan->gravity_acc);
+    free(plan->pre);
+    free(plan->post);
+    free(plan);
+}
+
+// Copies the steps in list into a plan array, reallocated to fit. Returns the number of updater operators (-1 if out of memory)
+static int rebx_plan_steps(struct rebx_extras* const rebx, struct rebx_node* list, struct rebx_plan_step** steps, int* N){
+    *N = rebx_len(list);
+    struct rebx_plan_step* new_steps = realloc(*steps, (*N > 0 ? *N : 1)*sizeof(**steps));
+    if (new_steps == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+        return -1;
+    }
+    *steps = new_steps;
+    int N_updaters = 0;
+    int i = 0;
+    for (struct rebx_node* current = list; current != NULL; current = current->next){
         struct rebx_step* step = current->object;
-        struct rebx_operator* operator = step->operator;
-        if(sim->integrator==REB_INTEGRATOR_IAS15 && sim->ri_ias15.epsilon != 0 && operator->operator_type == REBX_OPERATOR_UPDATER){
-            reb_simulation_warning(sim, "REBOUNDx: Operators that affect particle trajectories with adaptive timesteps can give spurious results. Use sim.ri_ias15.epsilon=0 for fixed timestep with IAS, or use a different integrator.");
+        new_steps[i].operator = step->operator;
+        new_steps[i].dt_fraction = step->dt_fraction;
+        if (step->operator->operator_type == REBX_OPERATOR_UPDATER){
+            N_updaters++;
         }
-        operator->step_function(sim, operator, dt*step->dt_fraction);
-        current = current->next;
+        i++;
     }
+    return N_updaters;
 }
 
-void rebx_post_timestep_modifications(struct reb_simulation* sim){
-    if(sim->N_var != 0){
+static struct rebx_plan* rebx_build_plan(struct rebx_extras* const rebx){
+    struct reb_simulation* const sim = rebx->sim;
+    if (rebx->plan == NULL){
+        rebx->plan = calloc(1, sizeof(*rebx->plan));
+        if (rebx->plan == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+            return NULL;
+        }
+    }
+    struct rebx_plan* const plan = rebx->plan;
+
+    plan->N_forces = rebx_len(rebx->additional_forces);
+    struct rebx_force** forces = realloc(plan->forces, (plan->N_forces > 0 ? plan->N_forces : 1)*sizeof(*forces));
+    if (forces == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+        return NULL;
+    }
+    plan->forces = forces;
+    int i = 0;
+    for (struct rebx_node* current = rebx->additional_forces; current != NULL; current = current->next){
+        forces[i++] = current->object;
+    }
+    void (**independent)(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N) = realloc(plan->independent, (plan->N_forces > 0 ? plan->N_forces : 1)*sizeof(*independent));
+    if (independent == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Could not allocate memory.\n");
+        return NULL;
+    }
+    plan->independent = independent;
+    plan->N_independent = 0;
+    plan->gravity_acc_users = 0;
+    for (i=0; i<plan->N_forces; i++){
+        // Built-in forces only write accelerations to the particles array they are passed. Ones that set parameters or draw random numbers share state, and custom forces are unknown, so those run on their own
+        const struct rebx_effect_descriptor* const effect = rebx_get_effect_descriptor(forces[i]->name);
+        independent[i] = NULL;
+        if (effect != NULL && effect->update_accelerations != NULL && !(effect->capabilities & (REBX_EFFECT_MODIFIES_PARAMS | REBX_EFFECT_RANDOM))){
+            independent[i] = effect->update_accelerations;
+            plan->N_independent++;
+        }
+        if (effect != NULL && (effect->capabilities & REBX_EFFECT_USES_GRAVITY)){
+            plan->gravity_acc_users++;
+        }
+    }
+    const int N_pre_updaters = rebx_plan_steps(rebx, rebx->pre_timestep_modifications, &plan->pre, &plan->N_pre);
+    const int N_post_updaters = rebx_plan_steps(rebx, rebx->post_timestep_modifications, &plan->post, &plan->N_post);
+    if (N_pre_updaters < 0 || N_post_updaters < 0){
+        return NULL;
+    }
+
+    plan->integrator = sim->integrator;
+    plan->N_var = sim->N_var;
+    plan->force_is_velocity_dependent = sim->force_is_velocity_dependent;
+    plan->ias15_adaptive = (sim->ri_ias15.epsilon != 0);
+    plan->valid = 1;
+
+    if (plan->N_var != 0 && (plan->N_forces || plan->N_pre || plan->N_post)){
         reb_simulation_warning(sim, "REBOUNDx: Variational particles have been added to the simulation but are not implemented in REBOUNDx and will not be evolved self-consistently.");
     }
-    struct rebx_extras* rebx = sim->extras;
-    struct rebx_node* current = rebx->post_timestep_modifications;
-    const double dt = sim->dt;
+    if (plan->N_forces && plan->force_is_velocity_dependent && plan->integrator == REB_INTEGRATOR_WHFAST){
+        reb_simulation_warning(sim, "REBOUNDx: Passing a velocity-dependent force to WHFAST. Need to apply as an operator. See REBOUNDx paper sec 5.1.");
+    }
+    if ((N_pre_updaters || N_post_updaters) && plan->integrator == REB_INTEGRATOR_IAS15 && plan->ias15_adaptive){
+        reb_simulation_warning(sim, "REBOUNDx: Operators that affect particle trajectories with adaptive timesteps can give spurious results. Use sim.ri_ias15.epsilon=0 for fixed timestep with IAS, or use a different integrator.");
+    }
+    return plan;
+}
 
-    while(current != NULL){
-        struct rebx_step* step = current->object;
-        struct rebx_operator* operator = step->operator;
-        if(sim->integrator==REB_INTEGRATOR_IAS15 && sim->ri_ias15.epsilon != 0 && operator->operator_type == REBX_OPERATOR_UPDATER){
-            reb_simulation_warning(sim, "REBOUNDx: Operators that affect particle trajectories with adaptive timesteps can give spurious results. Use sim.ri_ias15.epsilon=0 for fixed timestep with IAS, or use a different integrator.");
+static struct rebx_plan* rebx_get_plan(struct rebx_extras* const rebx){
+    struct reb_simulation* const sim = rebx->sim;
+    struct rebx_plan* const plan = rebx->plan;
+    if (plan != NULL && plan->valid
+            && plan->integrator == (int)sim->integrator
+            && plan->N_var == sim->N_var
+            && plan->force_is_velocity_dependent == sim->force_is_velocity_dependent
+            && plan->ias15_adaptive == (sim->ri_ias15.epsilon != 0)){
+        return plan;
+    }
+    return rebx_build_plan(rebx);
+}
+
+// Interpolated params only change with time, so they are evaluated once for every distinct sim->t (e.g. once per IAS15 substep) rather than on every call
+void rebx_update_interpolated_params(struct rebx_extras* const rebx){
+    const double t = rebx->sim->t;
+    if (rebx->N_interpolated_params == 0 || t == rebx->interpolated_params_t){
+        return;
+    }
+    for (int i=0; i<rebx->N_interpolated_params; i++){
+        const struct rebx_interpolated_param* const binding = &rebx->interpolated_params[i];
+        *(double*)binding->param->value = rebx_interpolate(rebx, binding->interpolator, t);
+    }
+    rebx->interpolated_params_t = t;
+}
+
+// Evaluates the independent forces concurrently as OpenMP tasks, each on a private copy of the particles with zeroed accelerations.
+// The copies' accelerations are then added to the particles in plan order, interleaved with the forces that must run on their own,
+// so results don't depend on which task finishes first. Errors and warnings raised by the tasks are reported at the same point.
+static void rebx_additional_forces_tasks(struct reb_simulation* const sim, struct rebx_plan* const plan, const int N){
+    const size_t N_task_particles = (size_t)plan->N_independent*N;
+    if (N_task_particles > plan->N_allocated_task_particles){
+        struct reb_particle* task_particles = realloc(plan->task_particles, N_task_particles*sizeof(*task_particles));
+        if (task_particles == NULL){
+            rebx_error(sim->extras, "REBOUNDx Error: Could not allocate memory for parallel force evaluation.\n");
+            return;
         }
-        operator->step_function(sim, operator, dt*step->dt_fraction);
-        current = current->next;
+        plan->task_particles = task_particles;
+        plan->N_allocated_task_particles = N_task_particles;
+    }
+    if (plan->N_independent > plan->N_allocated_task_messages){
+        struct rebx_task_messages* task_messages = realloc(plan->task_messages, plan->N_independent*sizeof(*task_messages));
+        if (task_messages == NULL){
+            rebx_error(sim->extras, "REBOUNDx Error: Could not allocate memory for parallel force evaluation.\n");
+            return;
+        }
+        plan->task_messages = task_messages;
+        plan->N_allocated_task_messages = plan->N_independent;
+    }
+    for (int k=0; k<plan->N_independent; k++){
+        plan->task_messages[k].first = NULL;
+        plan->task_messages[k].last = NULL;
+    }
+    struct reb_particle* const particles = sim->particles;
+#pragma omp parallel
+#pragma omp single
+    {
+    int k = 0;
+    for (int i=0; i<plan->N_forces; i++){
+        struct rebx_force* const force = plan->forces[i];
+        if (plan->independent[i] != NULL && plan->independent[i] == force->update_accelerations){
+            struct reb_particle* const ps = plan->task_particles + (size_t)k*N;
+            struct rebx_task_messages* const messages = &plan->task_messages[k];
+#pragma omp task firstprivate(force, ps, messages)
+            {
+            memcpy(ps, particles, N*sizeof(*ps));
+            rebx_reset_accelerations(ps, N);
+            rebx_current_task_messages = messages;
+            force->update_accelerations(sim, force, ps, N);
+            rebx_current_task_messages = NULL;
+            }
+        }
+        if (plan->independent[i] != NULL){
+            k++;
+        }
+    }
+    }
+    int k = 0;
+    for (int i=0; i<plan->N_forces; i++){
+        struct rebx_force* const force = plan->forces[i];
+        if (plan->independent[i] == NULL || plan->independent[i] != force->update_accelerations){ // update_accelerations can be replaced after the plan was built
+            force->update_accelerations(sim, force, particles, N);
+        }
+        else{
+            const struct reb_particle* const ps = plan->task_particles + (size_t)k*N;
+            for (int j=0; j<N; j++){
+                particles[j].ax += ps[j].ax;
+                particles[j].ay += ps[j].ay;
+                particles[j].az += ps[j].az;
+            }
+            rebx_report_task_messages(sim, &plan->task_messages[k]);
+        }
+        if (plan->independent[i] != NULL){
+            k++;
+        }
+    }
+}
+
+// When additional_forces is called, REBOUND has just computed the Newtonian accelerations. They are the full unsoftened
+// pairwise sums (what gr would compute itself) unless the gravity routine approximates them or leaves terms out.
+// Test particles need no check: gr sums over them like REBOUND does, feeling only the N_active bodies and pulling
+// back on them only with testparticle_type 1.
+static int rebx_gravity_acc_available(const struct reb_simulation* const sim){
+    return (sim->gravity == REB_GRAVITY_BASIC || sim->gravity == REB_GRAVITY_COMPENSATED)
+        && sim->gravity_ignore_terms == 0
+        && sim->softening == 0.
+        && sim->nghostx == 0 && sim->nghosty == 0 && sim->nghostz == 0;
+}
+
+// Saves the Newtonian accelerations before any force adds to them
+static void rebx_snapshot_gravity_acc(struct rebx_extras* const rebx, struct rebx_plan* const plan, const int N){
+    const size_t size = 3*(size_t)N;
+    if (size > plan->N_allocated_gravity_acc){
+        double* gravity_acc = realloc(plan->gravity_acc, size*sizeof(*gravity_acc));
+        if (gravity_acc == NULL){
+            return; // forces fall back to computing them
+        }
+        plan->gravity_acc = gravity_acc;
+        plan->N_allocated_gravity_acc = size;
+    }
+    const struct reb_particle* const particles = rebx->sim->particles;
+    for (int i=0; i<N; i++){
+        plan->gravity_acc[3*i] = particles[i].ax;
+        plan->gravity_acc[3*i+1] = particles[i].ay;
+        plan->gravity_acc[3*i+2] = particles[i].az;
+    }
+    plan->gravity_acc_valid = 1;
+}
+
+const double* rebx_get_gravity_acc(struct rebx_extras* const rebx){
+    const struct rebx_plan* const plan = rebx->plan;
+    return (plan != NULL && plan->gravity_acc_valid) ? plan->gravity_acc : NULL;
+}
+
+// WHFast's Jacobi coordinates match the inertial particles while it evaluates the forces within a step (after the drift,
+// it has just recalculated the particles from them), and in steppers that recalculate them right before (rebx_interaction_step).
+// They are only used if every particle is active, so that they are the same transformation gr would do itself.
+static int rebx_jacobi_particles_available(const struct reb_simulation* const sim, const struct rebx_plan* const plan, const int N){
+    const struct reb_integrator_whfast* const ri_whfast = &sim->ri_whfast;
+    return ri_whfast->p_jh != NULL
+        && ri_whfast->N_allocated >= (unsigned int)N
+        && ri_whfast->coordinates == REB_WHFAST_COORDINATES_JACOBI
+        && (sim->N_active <= 0 || sim->N_active >= N)
+        && (plan->whfast_jacobi_current || (sim->integrator == REB_INTEGRATOR_WHFAST && !ri_whfast->is_synchronized));
+}
+
+void rebx_set_whfast_jacobi_current(struct rebx_extras* const rebx, const int current){
+    struct rebx_plan* const plan = rebx->plan;   // not rebx_get_plan, which would rebuild an invalid plan (and warn) mid-step
+    if (plan != NULL){
+        plan->whfast_jacobi_current = current;
+    }
+}
+
+const struct reb_particle* rebx_get_jacobi_particles(struct rebx_extras* const rebx){
+    const struct rebx_plan* const plan = rebx->plan;
+    return plan != NULL ? plan->jacobi_particles : NULL;
+}
+
+void rebx_additional_forces(struct reb_simulation* sim){
+    struct rebx_extras* const rebx = sim->extras;
+    struct rebx_plan* const plan = rebx_get_plan(rebx);
+    if (plan == NULL){
+        return;
+    }
+    rebx_update_interpolated_params(rebx);
+    const int N = sim->N - sim->N_var;
+    if (plan->gravity_acc_users && rebx_gravity_acc_available(sim)){
+        rebx_snapshot_gravity_acc(rebx, plan, N);
+    }
+    plan->jacobi_particles = rebx_jacobi_particles_available(sim, plan, N) ? sim->ri_whfast.p_jh : NULL;
+    if (rebx->parallel_forces && plan->N_independent > 1){
+        rebx_additional_forces_tasks(sim, plan, N);
+    }
+    else{
+        for (int i=0; i<plan->N_forces; i++){
+            struct rebx_force* const force = plan->forces[i];
+            force->update_accelerations(sim, force, sim->particles, N);
+        }
+    }
+    plan->gravity_acc_valid = 0;
+    plan->jacobi_particles = NULL;
+}
+
+void rebx_pre_timestep_modifications(struct reb_simulation* sim){
+    const struct rebx_plan* const plan = rebx_get_plan(sim->extras);
+    if (plan == NULL){
+        return;
+    }
+    rebx_update_interpolated_params(sim->extras);
+    const double dt = sim->dt;
+    for (int i=0; i<plan->N_pre; i++){
+        struct rebx_operator* const operator = plan->pre[i].operator;
+        operator->step_function(sim, operator, dt*plan->pre[i].dt_fraction);
+    }
+}
+
+void rebx_post_timestep_modifications(struct reb_simulation* sim){
+    const struct rebx_plan* const plan = rebx_get_plan(sim->extras);
+    if (plan == NULL){
+        return;
+    }
+    rebx_update_interpolated_params(sim->extras);
+    const double dt = sim->dt;
+    for (int i=0; i<plan->N_post; i++){
+        struct rebx_operator* const operator = plan->post[i].operator;
+        operator->step_function(sim, operator, dt*plan->post[i].dt_fraction);
     }
 }
 
@@ -1062,6 +2512,9 @@ struct rebx_param* rebx_create_param(struct rebx_extras* rebx, const char* name,
     }
     param->type = type;
     param->value = NULL;
+    param->key = -1;
+    param->length = 0;
+    param->pooled = 0;
     param->name = rebx_malloc(rebx, strlen(name) + 1); // +1 for \0 at end
     if (param->name == NULL){
         return NULL;
@@ -1080,17 +2533,26 @@ int rebx_add_param(struct rebx_extras* const rebx, struct rebx_node** apptr, str
     }
     node->object = param;
     rebx_add_node(apptr, node);
+    rebx->param_generation++;
     return 1;
 }
 
+int rebx_get_param_key(struct rebx_extras* const rebx, const char* const param_name){
+    const int key = rebx_index_lookup(rebx, rebx_default_param_index, REBX_DEFAULT_PARAM_INDEX_SIZE-1, param_name);
+    if (key >= 0 || rebx->param_index == NULL){
+        return key;
+    }
+    return rebx_index_lookup(rebx, rebx->param_index, rebx->N_allocated_param_index-1, param_name);
+}
+
 // needed from Python
 enum rebx_param_type rebx_get_type(struct rebx_extras* rebx, const char* name){
-    struct rebx_param* param = rebx_get_param_struct(rebx, rebx->registered_params, name);
+    const int key = rebx_get_param_key(rebx, name);
 
-    if (param == NULL){ // param not found
+    if (key < 0){ // param not found
         return REBX_TYPE_NONE;
     }
-    return param->type;
+    return rebx_get_registered_param(rebx, key)->type;
 }
 
 size_t rebx_sizeof(struct rebx_extras* rebx, enum rebx_param_type type){
@@ -1111,6 +2573,22 @@ size_t rebx_sizeof(struct rebx_extras* rebx, enum rebx_param_type type){
         {
             return sizeof(struct reb_vec3d);
         }
+        case REBX_TYPE_UINT32:
+        {
+            return sizeof(uint32_t);
+        }
+        case REBX_TYPE_ORBIT:
+        {
+            return sizeof(struct reb_orbit);
+        }
+        case REBX_TYPE_DOUBLE_ARRAY: // size of one element
+        {
+            return sizeof(double);
+        }
+        case REBX_TYPE_INT_ARRAY:
+        {
+            return sizeof(int);
+        }
         case REBX_TYPE_POINTER:
         {
             return 0;
@@ -1129,10 +2607,25 @@ size_t rebx_sizeof(struct rebx_extras* rebx, enum rebx_param_type type){
 }
 
 void rebx_error(struct rebx_extras* rebx, const char* const msg){
-    if (rebx->sim == NULL){
+    if (rebx_current_task_messages != NULL){
+        rebx_queue_task_message(rebx_current_task_messages, 1, msg);
+    }
+    else if (rebx->sim == NULL){
         fprintf(stderr, "REBOUNDx Error: A Simulation is no longer attached to this REBOUNDx extras instance. Most likely the Simulation has been freed.\n");
     }
     else{
         reb_simulation_error(rebx->sim, msg);
     }
 }
+
+void rebx_warning(struct rebx_extras* rebx, const char* const msg){
+    if (rebx_current_task_messages != NULL){
+        rebx_queue_task_message(rebx_current_task_messages, 0, msg);
+    }
+    else if (rebx->sim == NULL){
+        fprintf(stderr, "REBOUNDx Error: A Simulation is no longer attached to this REBOUNDx extras instance. Most likely the Simulation has been freed.\n");
+    }
+    else{
+        reb_simulation_warning(rebx->sim, msg);
+    }
+}
@@ -43,7 +43,6 @@ struct rebx_node;
  ****************************/
 
 void rebx_initialize(struct reb_simulation* sim, struct rebx_extras* rebx); // Initializes all pointers and values.
-void rebx_register_default_params(struct rebx_extras* rebx); // Registers default params
 void rebx_init_interpolator(struct rebx_extras* const rebx, struct rebx_interpolator* const interp, const int Nvalues, const double* times, const double* values, enum rebx_interpolation_type interpolation);
 
 /**********************************************
@@ -53,6 +52,12 @@ void rebx_init_interpolator(struct rebx_extras* const rebx, struct rebx_interpol
 void rebx_additional_forces(struct reb_simulation* sim);                       // Calls all the forces that have been added to the simulation.
 void rebx_pre_timestep_modifications(struct reb_simulation* sim);   // Calls all the pre-timestep modifications that have been added to the simulation.
 void rebx_post_timestep_modifications(struct reb_simulation* sim);  // Calls all the post-timestep modifications that have been added to the simulation.
+void rebx_invalidate_plan(struct rebx_extras* const rebx);          // Forces the execution plan to be rebuilt before the next call to one of the above.
+void rebx_free_plan(struct rebx_plan* const plan);
+void rebx_update_interpolated_params(struct rebx_extras* const rebx);  // Refreshes params bound to interpolators if sim->t changed since the last refresh.
+const double* rebx_get_gravity_acc(struct rebx_extras* const rebx);   // Newtonian accelerations (3 per particle) REBOUND computed before the additional forces, or NULL outside of additional_forces or if they are incomplete
+const struct reb_particle* rebx_get_jacobi_particles(struct rebx_extras* const rebx);   // WHFast's Jacobi particles (positions and velocities) if they match the particles passed to the additional forces, otherwise NULL
+void rebx_set_whfast_jacobi_current(struct rebx_extras* const rebx, const int current); // Steppers mark WHFast's Jacobi particles as just recalculated from the inertial ones around a force evaluation
 
 /***********************************************************************************
  * Miscellaneous Functions
@@ -100,19 +105,27 @@ void rebx_integrator_rk4_integrate(struct reb_simulation* const sim, const doubl
 void rebx_integrator_implicit_midpoint_integrate(struct reb_simulation* const sim, const double dt, struct rebx_force* const force);
 
 void* rebx_malloc(struct rebx_extras* const rebx, size_t memsize);
-void rebx_free_ap(struct rebx_node** ap);
+void rebx_free_ap(struct rebx_extras* rebx, struct rebx_node** ap); // rebx can be NULL, in which case pooled params are left for the bulk free in rebx_free
 void rebx_free_particle_ap(struct reb_particle* p);
 void rebx_free_force(struct rebx_extras* rebx, struct rebx_force* force);
-void rebx_free_operator(struct rebx_operator* operator);
+void rebx_free_participants(struct rebx_participants* list);
+void rebx_free_acc_buffers(struct rebx_acc_buffers* buffers);
+void rebx_free_operator(struct rebx_extras* rebx, struct rebx_operator* operator);
 void rebx_free_step(struct rebx_step* step);
 void rebx_free_pointers(struct rebx_extras* rebx);
 void rebx_free_param(struct rebx_param* param);
 void rebx_free_interpolator_pointers(struct rebx_interpolator* const interpolator);
+struct rebx_interpolator* rebx_share_interpolator(struct rebx_extras* const rebx, struct rebx_interpolator* const interpolator); // Copy sharing interpolator's tables (copy-on-write: tables are never modified)
 
 enum rebx_param_type rebx_get_type(struct rebx_extras* rebx, const char* name);
+int rebx_intern_param(struct rebx_extras* const rebx, struct rebx_param* const reg_param); // Assigns next key to a param added to registered_params
+struct rebx_param* rebx_get_registered_param(struct rebx_extras* const rebx, const int key); // Registered param (default or user) for a valid key
 
 struct rebx_param* rebx_create_param(struct rebx_extras* rebx, const char* name, enum rebx_param_type type);
 int rebx_add_param(struct rebx_extras* const rebx, struct rebx_node** apptr, struct rebx_param* param);
+struct rebx_param* rebx_add_param_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key); // Allocates node, param and value in one block. Does not check for duplicates.
+size_t rebx_param_value_size(enum rebx_param_type type); // Size of values stored inline with the param (0 for types stored by reference)
 struct rebx_node* rebx_create_node(struct rebx_extras* rebx);
+int rebx_copy_extras(struct rebx_extras* const rebx_dst, struct rebx_extras* const rebx_src); // Deep copies forces, operators, steps and all params of rebx_src into a freshly attached rebx_dst
 
 #endif
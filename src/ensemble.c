@@ -0,0 +1,446 @@
+/**
+ * @file    ensemble.c
+ * @brief   Integrates many independent copies of a simulation sharing one REBOUNDx configuration
+ * @author  Dan Tamayo <tamayo.daniel@gmail.com>
+ *
+ * @section     LICENSE
+ * Copyright (c) 2015 Dan Tamayo, Hanno Rein
+ *
+ * This file is part of reboundx.
+ *
+ * reboundx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * reboundx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with rebound.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include "rebound.h"
+#include "reboundx.h"
+#include "core.h"
+#ifdef OPENMP
+#include <omp.h>
+#endif
+#ifndef _WIN32
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#endif
+
+// Override table resolved against the template, so members don't look up names or report configuration errors
+struct rebx_ensemble_target{
+    int key;
+    int effect;         // index of the force (or operator) in the template's allocated list, -1 for particles
+    int is_operator;
+    int index;
+};
+
+static int rebx_ensemble_effect_index(struct rebx_node* list, const char* const name){
+    int i = 0;
+    for (struct rebx_node* current = list; current != NULL; current = current->next, i++){
+        const char* const effect_name = ((struct rebx_force*)current->object)->name;
+        if (effect_name != NULL && strcmp(effect_name, name) == 0){
+            return i;
+        }
+    }
+    return -1;
+}
+
+static void* rebx_ensemble_effect(struct rebx_node* list, int i){
+    struct rebx_node* current = list;
+    while (i-- > 0){
+        current = current->next;
+    }
+    return current->object;
+}
+
+static int rebx_ensemble_valid(struct rebx_extras* const rebx, const struct rebx_ensemble* const ensemble){
+    if (ensemble == NULL || ensemble->N_members < 0 || ensemble->N_params < 0 || (ensemble->N_params > 0 && ensemble->params == NULL)){
+        rebx_error(rebx, "REBOUNDx Error: Invalid ensemble configuration.\n");
+        return 0;
+    }
+    return 1;
+}
+
+static int rebx_ensemble_resolve(struct rebx_extras* const rebx, const struct rebx_ensemble* const ensemble, struct rebx_ensemble_target* const targets){
+    char str[300];
+    for (int j=0; j<ensemble->N_params; j++){
+        const struct rebx_ensemble_param* const param = &ensemble->params[j];
+        struct rebx_ensemble_target* const target = &targets[j];
+        if (param->name == NULL || param->values == NULL){
+            rebx_error(rebx, "REBOUNDx Error: Ensemble parameters need a name and values.\n");
+            return 0;
+        }
+        target->key = rebx_get_param_key(rebx, param->name);
+        if (target->key < 0 || rebx_get_type(rebx, param->name) != REBX_TYPE_DOUBLE){
+            sprintf(str, "REBOUNDx Error: Ensemble parameter '%s' must be registered as REBX_TYPE_DOUBLE.\n", param->name);
+            rebx_error(rebx, str);
+            return 0;
+        }
+        target->effect = -1;
+        target->is_operator = 0;
+        target->index = param->index;
+        if (param->effect != NULL){
+            target->effect = rebx_ensemble_effect_index(rebx->allocated_forces, param->effect);
+            if (target->effect < 0){
+                target->effect = rebx_ensemble_effect_index(rebx->allocated_operators, param->effect);
+                target->is_operator = 1;
+            }
+            if (target->effect < 0){
+                sprintf(str, "REBOUNDx Error: Ensemble parameter '%s' refers to effect '%s', which was not loaded.\n", param->name, param->effect);
+                rebx_error(rebx, str);
+                return 0;
+            }
+        }
+        else if (param->index < 0 || param->index >= rebx->sim->N){
+            sprintf(str, "REBOUNDx Error: Ensemble parameter '%s' refers to particle %d, which does not exist.\n", param->name, param->index);
+            rebx_error(rebx, str);
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static void rebx_ensemble_record_particles(struct reb_simulation* const sim, double* const results){
+    for (int i=0; i<sim->N; i++){
+        const struct reb_particle* const p = &sim->particles[i];
+        results[6*i] = p->x;
+        results[6*i+1] = p->y;
+        results[6*i+2] = p->z;
+        results[6*i+3] = p->vx;
+        results[6*i+4] = p->vy;
+        results[6*i+5] = p->vz;
+    }
+}
+
+// Applies the override table and the setup callback to a freshly created member
+static void rebx_ensemble_apply(struct reb_simulation* const sim, struct rebx_extras* const rebx, const struct rebx_ensemble* const ensemble, const struct rebx_ensemble_target* const targets, const int member){
+    for (int j=0; j<ensemble->N_params; j++){
+        const struct rebx_ensemble_target* const target = &targets[j];
+        struct rebx_node** apptr;
+        if (target->effect < 0){
+            apptr = (struct rebx_node**)&sim->particles[target->index].ap;
+        }
+        else if (target->is_operator){
+            apptr = &((struct rebx_operator*)rebx_ensemble_effect(rebx->allocated_operators, target->effect))->ap;
+        }
+        else{
+            apptr = &((struct rebx_force*)rebx_ensemble_effect(rebx->allocated_forces, target->effect))->ap;
+        }
+        rebx_set_param_double_by_key(rebx, apptr, target->key, ensemble->params[j].values[member]);
+    }
+    if (ensemble->setup){
+        ensemble->setup(sim, rebx, member, ensemble->ref);
+    }
+}
+
+static void rebx_ensemble_run_member(struct rebx_extras* const rebx_template, struct rebx_ensemble* const ensemble, const struct rebx_ensemble_target* const targets, const int member){
+    double* const results = ensemble->results + (size_t)member*ensemble->N_results;
+    struct reb_simulation* sim;
+#pragma omp critical (rebx_ensemble_copy)
+    sim = reb_simulation_copy(rebx_template->sim);
+    struct rebx_extras* rebx = sim ? rebx_copy(sim, rebx_template) : NULL;
+    if (rebx == NULL){
+        for (int k=0; k<ensemble->N_results; k++){
+            results[k] = NAN;
+        }
+        if (ensemble->status){
+            ensemble->status[member] = REB_STATUS_GENERIC_ERROR;
+        }
+        if (sim){
+            reb_simulation_free(sim);
+        }
+        return;
+    }
+
+    rebx_ensemble_apply(sim, rebx, ensemble, targets, member);
+
+    const enum REB_STATUS status = reb_simulation_integrate(sim, ensemble->tmax);
+    if (ensemble->status){
+        ensemble->status[member] = status;
+    }
+    if (ensemble->record){
+        ensemble->record(sim, rebx, member, results, ensemble->ref);
+    }
+    else{
+        rebx_ensemble_record_particles(sim, results);
+    }
+    rebx_free(rebx);
+    reb_simulation_free(sim);
+}
+
+int rebx_integrate_ensemble(struct rebx_extras* const rebx, struct rebx_ensemble* const ensemble){
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return 0;
+    }
+    if (!rebx_ensemble_valid(rebx, ensemble)){
+        return 0;
+    }
+    if (ensemble->N_members > 0 && ensemble->N_results > 0 && ensemble->results == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Need to allocate the ensemble's results array.\n");
+        return 0;
+    }
+    if (ensemble->record == NULL && ensemble->N_results != 6*rebx->sim->N){
+        rebx_error(rebx, "REBOUNDx Error: Without a record function, the ensemble records the particles' positions and velocities, so N_results must be 6*N.\n");
+        return 0;
+    }
+    struct rebx_ensemble_target* const targets = rebx_malloc(rebx, ensemble->N_params*sizeof(*targets));
+    if (targets == NULL && ensemble->N_params > 0){
+        return 0;
+    }
+    if (!rebx_ensemble_resolve(rebx, ensemble, targets)){
+        free(targets);
+        return 0;
+    }
+
+    // Members are handed out one at a time, so threads that finish early pick up the remaining ones
+#ifdef OPENMP
+    const int N_threads = ensemble->N_threads > 0 ? ensemble->N_threads : omp_get_max_threads();
+#pragma omp parallel for schedule(dynamic, 1) num_threads(N_threads)
+#endif
+    for (int member=0; member<ensemble->N_members; member++){
+        rebx_ensemble_run_member(rebx, ensemble, targets, member);
+    }
+    free(targets);
+    return 1;
+}
+
+/*****************************
+ Multi-process ensembles
+ ****************************/
+
+struct rebx_ensemble_member_record* rebx_ensemble_file_member(struct rebx_ensemble_file_header* const header, const int member){
+    return (struct rebx_ensemble_member_record*)((char*)header + header->offset_records + member*header->record_size);
+}
+
+#ifndef _WIN32
+static const char rebx_ensemble_signature[] = "REBOUNDx Ensemble File";
+
+static void rebx_ensemble_fill_record(struct reb_simulation* const sim, struct rebx_extras* const rebx, struct rebx_ensemble_member_record* const record, const double E0){
+    const int min_distance_key = rebx_get_param_key(rebx, "min_distance");
+    const int spin_key = rebx_get_param_key(rebx, "Omega");
+    const double E = reb_simulation_energy(sim);
+    record->t = sim->t;
+    record->energy_error = (E0 != 0.) ? fabs((E-E0)/E0) : fabs(E-E0);
+    for (int i=0; i<sim->N; i++){
+        const struct reb_particle* const p = &sim->particles[i];
+        struct rebx_ensemble_particle_record* const prec = &record->particles[i];
+        prec->x = p->x;
+        prec->y = p->y;
+        prec->z = p->z;
+        prec->vx = p->vx;
+        prec->vy = p->vy;
+        prec->vz = p->vz;
+        int err = 1;
+        struct reb_orbit o = {0};
+        if (i > 0){
+            o = reb_orbit_from_particle_err(sim->G, *p, sim->particles[0], &err);
+        }
+        prec->a = err ? NAN : o.a;
+        prec->e = err ? NAN : o.e;
+        prec->inc = err ? NAN : o.inc;
+        prec->Omega = err ? NAN : o.Omega;
+        prec->omega = err ? NAN : o.omega;
+        prec->f = err ? NAN : o.f;
+        const double* const min_distance = rebx_get_param_by_key(rebx, p->ap, min_distance_key);
+        prec->min_distance = min_distance ? *min_distance : NAN;
+        const struct reb_vec3d* const spin = rebx_get_param_by_key(rebx, p->ap, spin_key);
+        prec->spin = spin ? *spin : (struct reb_vec3d){NAN, NAN, NAN};
+    }
+}
+
+// Sets a member up from the template simulation and the binary stored in the result file, integrates it and writes its record
+static enum REB_STATUS rebx_ensemble_run_process_member(struct reb_simulation* const template, struct rebx_ensemble_file_header* const header, const struct rebx_ensemble* const ensemble, const struct rebx_ensemble_target* const targets, const int member){
+    struct rebx_ensemble_member_record* const record = rebx_ensemble_file_member(header, member);
+    struct reb_simulation* const sim = reb_simulation_copy(template);
+    if (sim == NULL){
+        return REB_STATUS_GENERIC_ERROR;
+    }
+    struct rebx_extras* const rebx = rebx_attach(sim);
+    enum rebx_input_binary_messages warnings = REBX_INPUT_BINARY_WARNING_NONE;
+    rebx_init_extras_from_buffer(rebx, (const char*)header + header->offset_binary, header->binary_size, &warnings);
+    const enum rebx_input_binary_messages errors = REBX_INPUT_BINARY_ERROR_NOFILE | REBX_INPUT_BINARY_ERROR_CORRUPT | REBX_INPUT_BINARY_ERROR_NO_MEMORY | REBX_INPUT_BINARY_ERROR_REBX_NOT_LOADED | REBX_INPUT_BINARY_ERROR_REGISTERED_PARAM_NOT_LOADED;
+    if (warnings & errors){
+        rebx_free(rebx);
+        reb_simulation_free(sim);
+        return REB_STATUS_GENERIC_ERROR;
+    }
+    // Spin ODEs are not saved in binaries, so they are recreated as after any binary load
+    for (struct rebx_node* current = rebx->allocated_forces; current != NULL; current = current->next){
+        struct rebx_force* const force = current->object;
+        if (strcmp(force->name, "tides_spin") == 0){
+            rebx_spin_initialize_ode(rebx, force);
+        }
+    }
+
+    rebx_ensemble_apply(sim, rebx, ensemble, targets, member);
+
+    const double E0 = reb_simulation_energy(sim);
+    const enum REB_STATUS status = reb_simulation_integrate(sim, ensemble->tmax);
+    rebx_ensemble_fill_record(sim, rebx, record, E0);
+    rebx_free(rebx);
+    reb_simulation_free(sim);
+    return status;
+}
+
+static void rebx_ensemble_worker(struct reb_simulation* const template, struct rebx_ensemble_file_header* const header, const struct rebx_ensemble* const ensemble, const struct rebx_ensemble_target* const targets, const int worker){
+    while (1){
+        const long member = __atomic_fetch_add(&header->next_member, 1, __ATOMIC_RELAXED);
+        if (member >= header->N_members){
+            break;
+        }
+        struct rebx_ensemble_member_record* const record = rebx_ensemble_file_member(header, member);
+        record->worker = worker;
+        const enum REB_STATUS status = rebx_ensemble_run_process_member(template, header, ensemble, targets, member);
+        __atomic_store_n(&record->status, status, __ATOMIC_RELEASE);
+        __atomic_fetch_add(&header->N_completed, 1, __ATOMIC_RELAXED);
+    }
+}
+#endif // _WIN32
+
+int rebx_integrate_ensemble_processes(struct rebx_extras* const rebx, struct rebx_ensemble* const ensemble, const char* const filename, int N_workers){
+#ifdef _WIN32
+    rebx_error(rebx, "REBOUNDx Error: rebx_integrate_ensemble_processes is not supported on Windows.\n");
+    return 0;
+#else
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return 0;
+    }
+    if (!rebx_ensemble_valid(rebx, ensemble)){
+        return 0;
+    }
+    if (filename == NULL){
+        rebx_error(rebx, "REBOUNDx Error: Need a filename for the ensemble's result file.\n");
+        return 0;
+    }
+    struct rebx_ensemble_target* const targets = rebx_malloc(rebx, ensemble->N_params*sizeof(*targets));
+    if (targets == NULL && ensemble->N_params > 0){
+        return 0;
+    }
+    if (!rebx_ensemble_resolve(rebx, ensemble, targets)){
+        free(targets);
+        return 0;
+    }
+    if (N_workers <= 0){
+        N_workers = (int)sysconf(_SC_NPROCESSORS_ONLN);
+    }
+    if (N_workers > ensemble->N_members){
+        N_workers = ensemble->N_members;
+    }
+    if (N_workers < 1){
+        N_workers = 1;
+    }
+
+    char* binary;
+    size_t binary_size;
+    rebx_output_binary_to_buffer(rebx, &binary, &binary_size);
+    if (binary == NULL){
+        free(targets);
+        return 0;
+    }
+
+    // Layout: header, REBOUNDx binary, member records (all 8-byte aligned)
+    const int N = rebx->sim->N;
+    const long offset_binary = sizeof(struct rebx_ensemble_file_header);
+    const long offset_records = (offset_binary + (long)binary_size + 7) & ~7L;
+    const long record_size = sizeof(struct rebx_ensemble_member_record) + N*sizeof(struct rebx_ensemble_particle_record);
+    const size_t file_size = offset_records + (size_t)ensemble->N_members*record_size;
+
+    const int fd = open(filename, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0 || ftruncate(fd, file_size) != 0){
+        rebx_error(rebx, "REBOUNDx Error: Could not create the ensemble's result file.\n");
+        if (fd >= 0){
+            close(fd);
+        }
+        free(binary);
+        free(targets);
+        return 0;
+    }
+    struct rebx_ensemble_file_header* const header = mmap(NULL, file_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    if (header == MAP_FAILED){
+        rebx_error(rebx, "REBOUNDx Error: Could not map the ensemble's result file.\n");
+        close(fd);
+        free(binary);
+        free(targets);
+        return 0;
+    }
+    strncpy(header->signature, rebx_ensemble_signature, sizeof(header->signature));
+    header->N_members = ensemble->N_members;
+    header->N = N;
+    header->N_workers = N_workers;
+    header->tmax = ensemble->tmax;
+    header->offset_binary = offset_binary;
+    header->binary_size = binary_size;
+    header->offset_records = offset_records;
+    header->record_size = record_size;
+    header->next_member = 0;
+    header->N_completed = 0;
+    memcpy((char*)header + offset_binary, binary, binary_size);
+    free(binary);
+    for (int member=0; member<ensemble->N_members; member++){
+        struct rebx_ensemble_member_record* const record = rebx_ensemble_file_member(header, member);
+        record->status = REB_STATUS_RUNNING;
+        record->worker = -1;
+    }
+
+    // Children inherit unflushed output buffers, so flush them before forking
+    fflush(stdout);
+    fflush(stderr);
+    pid_t* const pids = rebx_malloc(rebx, N_workers*sizeof(*pids));
+    int N_started = 0;
+    for (int worker=0; pids != NULL && worker<N_workers; worker++){
+        const pid_t pid = fork();
+        if (pid == 0){
+#ifdef OPENMP
+            omp_set_num_threads(1); // the OpenMP runtime's threads don't survive fork (starting a team can deadlock), so kernels run single-threaded
+#endif
+            rebx_ensemble_worker(rebx->sim, header, ensemble, targets, worker);
+            _exit(0);
+        }
+        if (pid < 0){
+            break;
+        }
+        pids[N_started++] = pid;
+    }
+    for (int i=0; i<N_started; i++){
+        while (waitpid(pids[i], NULL, 0) < 0 && errno == EINTR);
+    }
+    free(pids);
+    free(targets);
+
+    // Members whose worker crashed (or that no worker reached) are marked as failed
+    for (int member=0; member<ensemble->N_members; member++){
+        struct rebx_ensemble_member_record* const record = rebx_ensemble_file_member(header, member);
+        if (record->status == REB_STATUS_RUNNING){
+            record->status = REB_STATUS_GENERIC_ERROR;
+        }
+        if (ensemble->status){
+            ensemble->status[member] = record->status;
+        }
+    }
+    msync(header, file_size, MS_SYNC);
+    munmap(header, file_size);
+    close(fd);
+    if (N_started == 0 && ensemble->N_members > 0){
+        rebx_error(rebx, "REBOUNDx Error: Could not start any ensemble worker processes.\n");
+        return 0;
+    }
+    return 1;
+#endif // _WIN32
+}
@@ -58,7 +58,14 @@
 #include "reboundx.h"
 #include "rebxtools.h"
 
-static struct  reb_vec3d rebx_calculate_modify_orbits_forces_new(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p,  struct reb_particle* source){
+struct rebx_exponential_migration_keys{
+    int em_tau_a;
+    int em_aini;
+    int em_afin;
+};
+
+static struct  reb_vec3d rebx_calculate_modify_orbits_forces_new(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p,  struct reb_particle* source, const void* const keys_ptr){
+    const struct rebx_exponential_migration_keys* const keys = keys_ptr;
 
    struct reb_orbit o = reb_orbit_from_particle(sim->G, *p, *source);
 
@@ -66,9 +73,9 @@ static struct  reb_vec3d rebx_calculate_modify_orbits_forces_new(struct reb_simu
     double em_aini = 24.;
     double em_afin = 30.;    
 
-    const double* const em_tau_a_ptr = rebx_get_param(sim->extras, p->ap, "em_tau_a");
-    const double* const em_ainipoint = rebx_get_param(sim->extras, p->ap, "em_aini");
-    const double* const em_afinpoint = rebx_get_param(sim->extras, p->ap, "em_afin");
+    const double* const em_tau_a_ptr = rebx_get_param_by_key(sim->extras, p->ap, keys->em_tau_a);
+    const double* const em_ainipoint = rebx_get_param_by_key(sim->extras, p->ap, keys->em_aini);
+    const double* const em_afinpoint = rebx_get_param_by_key(sim->extras, p->ap, keys->em_afin);
 
     const double dvx = p->vx - source->vx;
     const double dvy = p->vy - source->vy;
@@ -108,5 +115,10 @@ void rebx_exponential_migration(struct reb_simulation* const sim, struct rebx_fo
     }
     const int back_reactions_inclusive = 1;
     const char* reference_name = "primary";
-    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_forces_new, particles, N);
+    const struct rebx_exponential_migration_keys keys = {
+        .em_tau_a = rebx_get_param_key(sim->extras, "em_tau_a"),
+        .em_aini = rebx_get_param_key(sim->extras, "em_aini"),
+        .em_afin = rebx_get_param_key(sim->extras, "em_afin"),
+    };
+    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_forces_new, &keys, particles, N);
 }
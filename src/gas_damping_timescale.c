@@ -64,13 +64,20 @@
 #include "reboundx.h"
 #include "rebxtools.h"
 
-static struct reb_vec3d rebx_calculate_gas_damping_timescale(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* planet, struct reb_particle* star){
+struct rebx_gas_damping_timescale_keys{
+    int d_factor;
+    int cs_coeff;
+    int tau_coeff;
+};
+
+static struct reb_vec3d rebx_calculate_gas_damping_timescale(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* planet, struct reb_particle* star, const void* const keys_ptr){
     struct rebx_extras* const rebx = sim->extras;
+    const struct rebx_gas_damping_timescale_keys* const keys = keys_ptr;
     struct reb_orbit o = reb_orbit_from_particle(sim->G, *planet, *star);
 
-    const double* const d_factor = rebx_get_param(rebx, planet->ap, "d_factor");
-    const double* const cs_coeff = rebx_get_param(rebx, force->ap, "cs_coeff");
-    const double* const tau_coeff = rebx_get_param(rebx, force->ap, "tau_coeff");
+    const double* const d_factor = rebx_get_param_by_key(rebx, planet->ap, keys->d_factor);
+    const double* const cs_coeff = rebx_get_param_by_key(rebx, force->ap, keys->cs_coeff);
+    const double* const tau_coeff = rebx_get_param_by_key(rebx, force->ap, keys->tau_coeff);
     
     struct reb_vec3d a = {0};
 
@@ -137,5 +144,10 @@ void rebx_gas_damping_timescale(struct reb_simulation* const sim, struct rebx_fo
     }
     const int back_reactions_inclusive = 1;
     const char* reference_name = "primary";
-    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_gas_damping_timescale, particles, N);
+    const struct rebx_gas_damping_timescale_keys keys = {
+        .d_factor = rebx_get_param_key(sim->extras, "d_factor"),
+        .cs_coeff = rebx_get_param_key(sim->extras, "cs_coeff"),
+        .tau_coeff = rebx_get_param_key(sim->extras, "tau_coeff"),
+    };
+    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_gas_damping_timescale, &keys, particles, N);
 }
@@ -46,6 +46,8 @@
  * Field (C type)               Required    Description
  * ============================ =========== ==================================================================
  * c (double)                   Yes         Speed of light, needs to be specified in the units used for the simulation.
+ * max_iterations (int)         No          Maximum number of Newton iterations for the velocity (default 10).
+ * gr_tolerance (double)        No          Relative tolerance on the squared velocity in that iteration (default DBL_EPSILON).
  * ============================ =========== ==================================================================
  *
  * 
@@ -60,76 +62,150 @@
 #include "rebound.h"
 #include "reboundx.h"
 #include "rebxtools.h"
+#include "core.h"
 
-static void rebx_calculate_gr(struct reb_simulation* const sim, struct reb_particle* const particles, const int N, const double C2, const double G, const int max_iterations){
-    
-    struct reb_particle* const ps = malloc(N*sizeof(*ps));
-    struct reb_particle* const ps_j = malloc(N*sizeof(*ps_j));
-    memcpy(ps, particles, N*sizeof(*ps));
+// The velocity entering the 1PN terms is the Jacobi velocity v divided by 1-A, where A = (vi2/2 + 3 mu/r)/c^2 only depends on
+// its square vi2. Solves the scalar equation vi2 = v^2/(1-A)^2 with Newton's method for all bodies at once, from vi2 = v^2.
+// v2[i] and mu_r[i] (mu/r) are the inputs for bodies i0..N-1, and vi2 the solutions. Returns 1 if it converged within max_iterations, 0 otherwise.
+static int rebx_gr_solve_vi2(const int i0, const int N, const double* const v2, const double* const mu_r, double* const vi2, const double C2, const double tolerance, const int max_iterations){
+    for (int i=i0; i<N; i++){
+        vi2[i] = v2[i];
+    }
+    for (int q=0; q<max_iterations; q++){
+        double max_excess = 0.;     // largest change beyond the tolerance
+        for (int i=i0; i<N; i++){
+            const double one_minus_A = 1. - (0.5*vi2[i] + 3.*mu_r[i])/C2;
+            const double rhs = v2[i]/(one_minus_A*one_minus_A);
+            const double dvi2 = (vi2[i] - rhs)/(1. - rhs/(one_minus_A*C2));
+            vi2[i] -= dvi2;
+            const double excess = fabs(dvi2) - tolerance*vi2[i];
+            max_excess = excess > max_excess ? excess : max_excess;
+        }
+        if (max_excess <= 0.){
+            return 1;
+        }
+    }
+    return 0;
+}
+
+static void rebx_calculate_gr(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N, const double C2, const double G, const double tolerance, const int max_iterations){
+    struct rebx_extras* const rebx = sim->extras;
+    // Scratch arrays for the accelerations in inertial and Jacobi coordinates (and the Jacobi positions and velocities), and
+    // for the velocity solve, kept on the force between calls
+    struct reb_particle* const ps = rebx_get_workspace(rebx, force, 2*N*sizeof(*ps) + 3*N*sizeof(double));
+    if (ps == NULL){
+        return;
+    }
+    struct reb_particle* const ps_j = ps + N;
+    double* const v2 = (double*)(ps_j + N);
+    double* const mu_r = v2 + N;
+    double* const vi2s = mu_r + N;
    
-    const int N_active = sim->N_active > 0 ? sim->N_active : N; // additional_forces passes N=N-N_var. Think about this if adding variational particles
-    // Calculate Newtonian accelerations 
-    for(int i=0; i<N; i++){
-        ps[i].ax = 0.;
-        ps[i].ay = 0.;
-        ps[i].az = 0.;
+    const int N_active = (sim->N_active > 0 && sim->N_active < N) ? sim->N_active : N; // additional_forces passes N=N-N_var. Think about this if adding variational particles
+    // Newtonian accelerations. Reuse the ones REBOUND just computed if possible
+    const double* const gravity_acc = rebx_get_gravity_acc(rebx);
+    if (gravity_acc != NULL){
+        for(int i=0; i<N; i++){
+            ps[i].ax = gravity_acc[3*i];
+            ps[i].ay = gravity_acc[3*i+1];
+            ps[i].az = gravity_acc[3*i+2];
+        }
     }
+    else{
+        for(int i=0; i<N; i++){
+            ps[i].ax = 0.;
+            ps[i].ay = 0.;
+            ps[i].az = 0.;
+        }
 
-    for(int i=0; i<N_active; i++){
-        const struct reb_particle pi = ps[i];
-        for(int j=i+1; j<N; j++){
-            const struct reb_particle pj = ps[j];
-            const double dx = pi.x - pj.x;
-            const double dy = pi.y - pj.y;
-            const double dz = pi.z - pj.z;
-            const double r2 = dx*dx + dy*dy + dz*dz;
-            const double r = sqrt(r2);
-            const double prefac = G/(r2*r);
-            ps[i].ax -= prefac*pj.m*dx;
-            ps[i].ay -= prefac*pj.m*dy;
-            ps[i].az -= prefac*pj.m*dz;
-            ps[j].ax += prefac*pi.m*dx;
-            ps[j].ay += prefac*pi.m*dy;
-            ps[j].az += prefac*pi.m*dz;
+        for(int i=0; i<N_active; i++){
+            const struct reb_particle pi = particles[i];
+            for(int j=i+1; j<N_active; j++){
+                const struct reb_particle pj = particles[j];
+                const double dx = pi.x - pj.x;
+                const double dy = pi.y - pj.y;
+                const double dz = pi.z - pj.z;
+                const double r2 = dx*dx + dy*dy + dz*dz;
+                const double r = sqrt(r2);
+                const double prefac = G/(r2*r);
+                ps[i].ax -= prefac*pj.m*dx;
+                ps[i].ay -= prefac*pj.m*dy;
+                ps[i].az -= prefac*pj.m*dz;
+                ps[j].ax += prefac*pi.m*dx;
+                ps[j].ay += prefac*pi.m*dy;
+                ps[j].az += prefac*pi.m*dz;
+            }
+        }
+
+        // Test particles only feel the active bodies. The few active bodies are the outer loop, so the loop over test particles has no dependencies
+        for(int i=0; i<N_active; i++){
+            const struct reb_particle pi = particles[i];
+            for(int j=N_active; j<N; j++){
+                const double dx = pi.x - particles[j].x;
+                const double dy = pi.y - particles[j].y;
+                const double dz = pi.z - particles[j].z;
+                const double r2 = dx*dx + dy*dy + dz*dz;
+                const double r = sqrt(r2);
+                const double prefac = G/(r2*r);
+                ps[j].ax += prefac*pi.m*dx;
+                ps[j].ay += prefac*pi.m*dy;
+                ps[j].az += prefac*pi.m*dz;
+            }
+        }
+        // With testparticle_type 1, test particles with mass also pull on the active bodies
+        if (sim->testparticle_type == 1){
+            for(int i=0; i<N_active; i++){
+                const struct reb_particle pi = particles[i];
+                for(int j=N_active; j<N; j++){
+                    const struct reb_particle pj = particles[j];
+                    if (pj.m == 0.){
+                        continue;
+                    }
+                    const double dx = pi.x - pj.x;
+                    const double dy = pi.y - pj.y;
+                    const double dz = pi.z - pj.z;
+                    const double r2 = dx*dx + dy*dy + dz*dz;
+                    const double r = sqrt(r2);
+                    const double prefac = G/(r2*r);
+                    ps[i].ax -= prefac*pj.m*dx;
+                    ps[i].ay -= prefac*pj.m*dy;
+                    ps[i].az -= prefac*pj.m*dz;
+                }
+            }
         }
     }
    
-    // Transform to Jacobi coordinates
-    const struct reb_particle source = ps[0];
+    // Transform to Jacobi coordinates. When WHFast evaluates the forces, it already has the positions and velocities
+    const struct reb_particle source = particles[0];
 	const double mu = G*source.m;
-    reb_particles_transform_inertial_to_jacobi_posvelacc(ps, ps_j, ps, N, N_active);
+    const struct reb_particle* ps_jh = rebx_get_jacobi_particles(rebx);
+    if (ps_jh == NULL){
+        reb_particles_transform_inertial_to_jacobi_posvel(particles, ps_j, particles, N, N_active);
+        ps_jh = ps_j;
+    }
+    reb_particles_transform_inertial_to_jacobi_acc(ps, ps_j, particles, N, N_active);
     
     for (int i=1; i<N; i++){
-        struct reb_particle p = ps_j[i];
-        struct reb_vec3d vi;
-        vi.x = p.vx;
-        vi.y = p.vy;
-        vi.z = p.vz;
-        double vi2=vi.x*vi.x + vi.y*vi.y + vi.z*vi.z;
+        const struct reb_particle p = ps_jh[i];
+        v2[i] = p.vx*p.vx + p.vy*p.vy + p.vz*p.vz;
+        mu_r[i] = mu/sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+    }
+    if (!rebx_gr_solve_vi2(1, N, v2, mu_r, vi2s, C2, tolerance, max_iterations)){
+        rebx_warning(sim->extras, "REBOUNDx Warning: The velocity iteration in gr.c failed to converge within max_iterations. This is typically because the perturbation is too strong for the current implementation.");
+    }
+
+    for (int i=1; i<N; i++){
+        struct reb_particle p = ps_jh[i];
+        p.ax = ps_j[i].ax;
+        p.ay = ps_j[i].ay;
+        p.az = ps_j[i].az;
         const double ri = sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
-        int q = 0;
-        double A = (0.5*vi2 + 3.*mu/ri)/C2;
-        struct reb_vec3d old_v;
-        for(q=0; q<max_iterations; q++){
-            old_v.x = vi.x;
-            old_v.y = vi.y;
-            old_v.z = vi.z;
-            vi.x = p.vx/(1.-A);
-            vi.y = p.vy/(1.-A);
-            vi.z = p.vz/(1.-A);
-            vi2 =vi.x*vi.x + vi.y*vi.y + vi.z*vi.z;
-            A = (0.5*vi2 + 3.*mu/ri)/C2;
-            const double dvx = vi.x - old_v.x;
-            const double dvy = vi.y - old_v.y;
-            const double dvz = vi.z - old_v.z;
-            if ((dvx*dvx + dvy*dvy + dvz*dvz)/vi2 < DBL_EPSILON*DBL_EPSILON){
-                break;
-            }
-        }
-        const int default_max_iterations = 10;
-        if(q==default_max_iterations){
-            reb_simulation_warning(sim, "REBOUNDx Warning: 10 iterations in gr.c failed to converge. This is typically because the perturbation is too strong for the current implementation.");
-        }
+        const double vi2 = vi2s[i];
+        const double A = (0.5*vi2 + 3.*mu_r[i])/C2;
+        struct reb_vec3d vi;
+        vi.x = p.vx/(1.-A);
+        vi.y = p.vy/(1.-A);
+        vi.z = p.vz/(1.-A);
   
         const double B = (mu/ri - 1.5*vi2)*mu/(ri*ri*ri)/C2;
         const double rdotrdot = p.x*p.vx + p.y*p.vy + p.z*p.vz;
@@ -151,39 +227,30 @@ static void rebx_calculate_gr(struct reb_simulation* const sim, struct reb_parti
     ps_j[0].ay = 0.;
     ps_j[0].az = 0.;
 
-    reb_particles_transform_jacobi_to_inertial_acc(ps, ps_j, ps, N, N_active);
+    reb_particles_transform_jacobi_to_inertial_acc(ps, ps_j, particles, N, N_active);
     for (int i=0; i<N; i++){
         particles[i].ax += ps[i].ax;
         particles[i].ay += ps[i].ay;
         particles[i].az += ps[i].az;
     }
-    
-    free(ps);
-    free(ps_j);
 }
 
 void rebx_gr(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N){
     double* c = rebx_get_param(sim->extras, force->ap, "c");
     if (c == NULL){
-        reb_simulation_error(sim, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
+        rebx_error(sim->extras, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
         return;
     }
     const double C2 = (*c)*(*c);
     int* max_iterations = rebx_get_param(sim->extras, force->ap, "max_iterations");
-    if(max_iterations != NULL){
-        rebx_calculate_gr(sim, particles, N, C2, sim->G, *max_iterations);
-    }
-    else{
-        const int default_max_iterations = 10;
-        rebx_calculate_gr(sim, particles, N, C2, sim->G, default_max_iterations);
-    }
+    double* tolerance = rebx_get_param(sim->extras, force->ap, "gr_tolerance");
+    rebx_calculate_gr(sim, force, particles, N, C2, sim->G, tolerance != NULL ? *tolerance : DBL_EPSILON, max_iterations != NULL ? *max_iterations : 10);
 }
 
-static double rebx_calculate_gr_hamiltonian(struct rebx_extras* const rebx, struct reb_simulation* const sim, const double C2){
+static double rebx_calculate_gr_hamiltonian(struct rebx_extras* const rebx, struct reb_simulation* const sim, const double C2, const double tolerance, const int max_iterations){
     const int N = sim->N - sim->N_var;
     const double G = sim->G;
 
-    struct reb_particle* const ps_j = malloc(N*sizeof(*ps_j));
     struct reb_particle* const ps = sim->particles; 
     // Calculate Newtonian potentials
 
@@ -204,34 +271,39 @@ static double rebx_calculate_gr_hamiltonian(struct rebx_extras* const rebx, stru
     // Transform to Jacobi coordinates
     const struct reb_particle source = ps[0];
 	const double mu = G*source.m;
-    double* const m_j = malloc(N*sizeof(*m_j));
+    double* const m_j = malloc(4*N*sizeof(*m_j));    // followed by the inputs and solutions of the velocity solve
+    double* const v2 = m_j + N;
+    double* const mu_r = v2 + N;
+    double* const vtilde2 = mu_r + N;
     rebx_calculate_jacobi_masses(ps, m_j, N);
-    reb_particles_transform_inertial_to_jacobi_posvel(ps, ps_j, ps, N, N);
+    // Use WHFast's Jacobi coordinates if it is evaluating the forces
+    struct reb_particle* ps_j_alloc = NULL;
+    const struct reb_particle* ps_j = rebx_get_jacobi_particles(rebx);
+    if (ps_j == NULL){
+        ps_j_alloc = malloc(N*sizeof(*ps_j_alloc));
+        reb_particles_transform_inertial_to_jacobi_posvel(ps, ps_j_alloc, ps, N, N);
+        ps_j = ps_j_alloc;
+    }
 
     double T = 0.5*m_j[0]*(ps_j[0].vx*ps_j[0].vx + ps_j[0].vy*ps_j[0].vy + ps_j[0].vz*ps_j[0].vz);
     double V_PN = 0.;
     for (int i=1; i<N; i++){
-        struct reb_particle p = ps_j[i];
-        const double rdoti2 = p.vx*p.vx + p.vy*p.vy + p.vz*p.vz;
-        double vtildei2 = rdoti2;
-        double A, old_vtildei2;
-        const double ri = sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
-        const double vscale2 = mu/ri; // characteristic v^2
-        for(int q=0; q<10; q++){
-            old_vtildei2 = vtildei2;
-            A = (0.5*vtildei2 + 3.*vscale2)/C2;
-            vtildei2 = rdoti2/((1.-A)*(1.-A));
-            if ((vtildei2 - old_vtildei2)/vtildei2 < DBL_EPSILON){
-                break;
-            }
-        }
+        const struct reb_particle p = ps_j[i];
+        v2[i] = p.vx*p.vx + p.vy*p.vy + p.vz*p.vz;
+        mu_r[i] = mu/sqrt(p.x*p.x + p.y*p.y + p.z*p.z);    // characteristic v^2
+    }
+    rebx_gr_solve_vi2(1, N, v2, mu_r, vtilde2, C2, tolerance, max_iterations);
 
+    for (int i=1; i<N; i++){
+        const struct reb_particle p = ps_j[i];
+        const double ri = sqrt(p.x*p.x + p.y*p.y + p.z*p.z);
+        const double vtildei2 = vtilde2[i];
         V_PN += m_j[i]*(0.5*mu*mu/(ri*ri) - 0.125*vtildei2*vtildei2 - 1.5*mu*vtildei2/ri);
         T += 0.5*m_j[i]*vtildei2;
     }
     V_PN /= C2;
     
-    free(ps_j);
+    free(ps_j_alloc);
     free(m_j);
     
 	return T + V_newt + V_PN;
@@ -244,6 +316,8 @@ double rebx_gr_hamiltonian(struct rebx_extras* const rebx, const struct rebx_for
         return 0;
     }
     const double C2 = (*c)*(*c);
-    return rebx_calculate_gr_hamiltonian(rebx, rebx->sim, C2);
+    int* max_iterations = rebx_get_param(rebx, gr->ap, "max_iterations");
+    double* tolerance = rebx_get_param(rebx, gr->ap, "gr_tolerance");
+    return rebx_calculate_gr_hamiltonian(rebx, rebx->sim, C2, tolerance != NULL ? *tolerance : DBL_EPSILON, max_iterations != NULL ? *max_iterations : 10);
 }
 
@@ -36,6 +36,9 @@
  * ======================= ===============================================
  * 
  * This algorithm incorporates the first-order post-newtonian effects from all bodies in the system, and is necessary for multiple massive bodies like stellar binaries.
+ * For large N (e.g. star clusters), setting gr_opening_angle approximates the pair sums Barnes-Hut style: distant groups of bodies are replaced by their center of mass,
+ * with mass-weighted sums of their velocities, potentials and accelerations. This makes an evaluation O(N log N), at the cost of errors that grow with the opening angle.
+ * Only the first N_active bodies act as sources (and go into the tree), unless testparticle_type is 1 and some test particles have mass, so many massless test particles cost O(N_active) each.
  *
  * **Effect Parameters**
  * 
@@ -43,6 +46,8 @@
  * Field (C type)               Required    Description
  * ============================ =========== ==================================================================
  * c (double)                   Yes         Speed of light, needs to be specified in the units used for the simulation.
+ * gr_opening_angle (double)    No          If set (> 0), sums over pairs use a tree in which cells that appear smaller than this angle act as a single body (default 0: exact).
+ * gr_N_direct (int)            No          The tree is only used for at least this many bodies (default 1000).
  * ============================ =========== ==================================================================
  * 
  * **Particle Parameters**
@@ -58,208 +63,617 @@
 #include "rebound.h"
 #include "reboundx.h"
 
-static void rebx_calculate_gr_full(struct reb_simulation* const sim, struct reb_particle* const particles, const int N, const double C2, const double G, const int max_iterations, const int gravity_ignore_10){
-    
-    double a_const[N][3]; // array that stores the value of the constant term
-    struct reb_particle* const ps_b = malloc(N*sizeof(*ps_b));
-    memcpy(ps_b, particles, N*sizeof(*ps_b));
-
-    // Calculate Newtonian accelerations 
-    for(int i=0; i<N; i++){
-        ps_b[i].ax = 0.;
-        ps_b[i].ay = 0.;
-        ps_b[i].az = 0.;
+#define REBX_GR_FULL_TILE 256     // Bodies j per tile. A block of bodies i sums over a tile while its positions, velocities and accelerations stay in cache
+#define REBX_GR_FULL_BLOCK 32     // Bodies i per parallel work item
+#define REBX_GR_FULL_LEAF 8       // Maximum number of bodies in a tree leaf (unless they coincide)
+#define REBX_GR_FULL_MAX_DEPTH 128
+
+// Per-body arrays, laid out contiguously in the force's workspace
+struct rebx_gr_full_arrays{
+    double* x;          // barycentric positions and velocities
+    double* y;
+    double* z;
+    double* vx;
+    double* vy;
+    double* vz;
+    double* m;
+    double* phi;        // sum over k!=i of G*m_k/r_ik
+    double* a_newt;     // Newtonian accelerations (3 per body)
+    double* a_const;    // part of the 1PN acceleration that does not depend on the 1PN accelerations
+    double* a;          // current and previous substitution
+    double* a_old;
+};
+
+// Tree cell. Distant cells act as a single body at their center of mass, carrying the mass-weighted sums of the quantities
+// the EIH pair terms depend on (velocities up to second order, potential sums and accelerations).
+struct rebx_gr_full_cell{
+    double bmin[3];     // bounding box of the bodies
+    double bmax[3];
+    double size2;       // squared largest extent of the bounding box
+    double M;
+    double com[3];
+    double mv[3];       // sum of m*v
+    double mv2;         // sum of m*v^2
+    double mvv[6];      // sum of m*v*v^T (xx, xy, xz, yy, yz, zz)
+    double mphi;        // sum of m*phi
+    double ma[3];       // sum of m*a_newt
+    double msa[3];      // sum of m*a_old
+    int first;          // bodies idx[first..first+count-1]
+    int count;
+    int child[2];       // -1 for leaves
+};
+
+struct rebx_gr_full_tree{
+    struct rebx_gr_full_cell* cells;    // in preorder, so children come after their parent
+    int N_cells;
+    int* idx;
+    double theta2;      // squared opening angle
+};
+
+// Bodies in leaves are at least REBX_GR_FULL_LEAF/2, since cells are split at the median
+static int rebx_gr_full_max_cells(const int N){
+    return 2*(N/(REBX_GR_FULL_LEAF/2)) + 1;
+}
+
+static int rebx_gr_full_get_arrays(struct reb_simulation* const sim, struct rebx_force* const force, const int N, struct rebx_gr_full_arrays* const arr, struct rebx_gr_full_tree* const tree){
+    size_t size = 20*(size_t)N*sizeof(double);
+    if (tree != NULL){
+        size += (size_t)rebx_gr_full_max_cells(N)*sizeof(struct rebx_gr_full_cell) + (size_t)N*sizeof(int);
+    }
+    double* const ws = rebx_get_workspace(sim->extras, force, size);
+    if (ws == NULL){
+        return 0;
     }
+    arr->x = ws;
+    arr->y = ws + N;
+    arr->z = ws + 2*N;
+    arr->vx = ws + 3*N;
+    arr->vy = ws + 4*N;
+    arr->vz = ws + 5*N;
+    arr->m = ws + 6*N;
+    arr->phi = ws + 7*N;
+    arr->a_newt = ws + 8*N;
+    arr->a_const = ws + 11*N;
+    arr->a = ws + 14*N;
+    arr->a_old = ws + 17*N;
+    if (tree != NULL){
+        tree->cells = (struct rebx_gr_full_cell*)(ws + 20*N);
+        tree->idx = (int*)(tree->cells + rebx_gr_full_max_cells(N));
+    }
+    return 1;
+}
 
-    for(int i=0; i<N; i++){
-        const struct reb_particle pi = ps_b[i];
-        for(int j=i+1; j<N; j++){
-            const struct reb_particle pj = ps_b[j];
-            const double dx = pi.x - pj.x;
-            const double dy = pi.y - pj.y;
-            const double dz = pi.z - pj.z;
-            const double r2 = dx*dx + dy*dy + dz*dz;
-            const double r = sqrt(r2);
-            const double prefac = G/(r2*r);
-            ps_b[i].ax -= prefac*pj.m*dx;
-            ps_b[i].ay -= prefac*pj.m*dy;
-            ps_b[i].az -= prefac*pj.m*dz;
-            ps_b[j].ax += prefac*pi.m*dx;
-            ps_b[j].ay += prefac*pi.m*dy;
-            ps_b[j].az += prefac*pi.m*dz;
+/*********************************
+ Pair terms, summed into the i body's accumulators
+ ********************************/
+
+static inline void rebx_gr_full_pair_newtonian(const struct rebx_gr_full_arrays* const arr, const int i, const int j, const double G, double* const acc, double* const phi){
+    const double dx = arr->x[i] - arr->x[j];
+    const double dy = arr->y[i] - arr->y[j];
+    const double dz = arr->z[i] - arr->z[j];
+    const double r2 = dx*dx + dy*dy + dz*dz;
+    const double r = sqrt(r2);
+    const double prefac = G/(r2*r);
+    acc[0] -= prefac*arr->m[j]*dx;
+    acc[1] -= prefac*arr->m[j]*dy;
+    acc[2] -= prefac*arr->m[j]*dz;
+    *phi += G*arr->m[j]/r;
+}
+
+static inline void rebx_gr_full_pair_constant(const struct rebx_gr_full_arrays* const arr, const int i, const int j, const double C2, const double G, const double vi2, double* const acc){
+    const double* const x = arr->x;
+    const double* const y = arr->y;
+    const double* const z = arr->z;
+    const double* const vx = arr->vx;
+    const double* const vy = arr->vy;
+    const double* const vz = arr->vz;
+    const double* const a_newt = arr->a_newt;
+    const double dxij = x[i] - x[j];
+    const double dyij = y[i] - y[j];
+    const double dzij = z[i] - z[j];
+    const double rij2 = dxij*dxij + dyij*dyij + dzij*dzij;
+    const double rij = sqrt(rij2);
+    const double rij3 = rij2*rij;
+
+    // 1st constant part. The potential sums only depend on i and j, so they are computed once beforehand
+    const double a1 = (4./(C2)) * arr->phi[i];
+    const double a2 = (1./(C2)) * arr->phi[j];
+    const double a3 = -vi2/(C2);
+    const double vj2 = vx[j]*vx[j] + vy[j]*vy[j] + vz[j]*vz[j];
+    const double a4 = -2.*vj2/(C2);
+    const double a5 = (4./(C2)) * (vx[i]*vx[j] + vy[i]*vy[j] + vz[i]*vz[j]);
+    const double a6_0 = dxij*vx[j] + dyij*vy[j] + dzij*vz[j];
+    const double a6 = (3./(2.*C2)) * a6_0*a6_0/rij2;
+    const double a7 = (dxij*a_newt[3*j]+dyij*a_newt[3*j+1]+dzij*a_newt[3*j+2])/(2.*C2); // Newtonian piece of first ddot(r) piece
+    const double factor1 = a1 + a2 + a3 + a4 + a5 + a6 + a7;
+
+    acc[0] += G*arr->m[j]*dxij*factor1/rij3;
+    acc[1] += G*arr->m[j]*dyij*factor1/rij3;
+    acc[2] += G*arr->m[j]*dzij*factor1/rij3;
+
+    // 2nd constant part
+    const double dvxij = vx[i] - vx[j];
+    const double dvyij = vy[i] - vy[j];
+    const double dvzij = vz[i] - vz[j];
+    const double factor2 = dxij*(4.*vx[i]-3.*vx[j])+dyij*(4.*vy[i]-3.*vy[j])+dzij*(4.*vz[i]-3.*vz[j]);
+
+    acc[0] += G*arr->m[j]/C2*(factor2*dvxij/rij3 + 7./2.*a_newt[3*j]/rij);
+    acc[1] += G*arr->m[j]/C2*(factor2*dvyij/rij3 + 7./2.*a_newt[3*j+1]/rij);
+    acc[2] += G*arr->m[j]/C2*(factor2*dvzij/rij3 + 7./2.*a_newt[3*j+2]/rij);
+}
+
+static inline void rebx_gr_full_pair_substitute(const struct rebx_gr_full_arrays* const arr, const int i, const int j, const double C2, const double G, double* const acc){
+    const double* const a_old = arr->a_old;
+    const double m = arr->m[j];
+    const double dxij = arr->x[i] - arr->x[j];
+    const double dyij = arr->y[i] - arr->y[j];
+    const double dzij = arr->z[i] - arr->z[j];
+    const double rij = sqrt(dxij*dxij + dyij*dyij + dzij*dzij);
+    const double rij3 = rij*rij*rij;
+    const double dotproduct = dxij*a_old[3*j]+dyij*a_old[3*j+1]+dzij*a_old[3*j+2];
+
+    acc[0] += (G*m*dxij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*m*a_old[3*j]/rij;
+    acc[1] += (G*m*dyij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*m*a_old[3*j+1]/rij;
+    acc[2] += (G*m*dzij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*m*a_old[3*j+2]/rij;
+}
+
+/*********************************
+ Tree
+ ********************************/
+
+// Partially sorts idx so that idx[k] is the body with the k-th smallest coordinate, with smaller ones before it and larger ones after
+static void rebx_gr_full_select(int* const idx, const int n, const int k, const double* const coord){
+    int lo = 0;
+    int hi = n-1;
+    while (hi > lo){
+        const double pivot = coord[idx[(lo+hi)/2]];
+        int a = lo;
+        int b = hi;
+        while (a <= b){
+            while (coord[idx[a]] < pivot) a++;
+            while (coord[idx[b]] > pivot) b--;
+            if (a <= b){
+                const int tmp = idx[a];
+                idx[a] = idx[b];
+                idx[b] = tmp;
+                a++;
+                b--;
+            }
+        }
+        if (k <= b){
+            hi = b;
+        }
+        else if (k >= a){
+            lo = a;
+        }
+        else{
+            break;
         }
     }
+}
 
-    // Transform to barycentric coordinates
-    struct reb_particle com = reb_simulation_com(sim);
-    for (int i=0; i<N; i++){
-        reb_particle_isub(&ps_b[i], &com);
+// Splits cells at the median along their longest extent. Returns the index of the new cell
+static int rebx_gr_full_build(struct rebx_gr_full_tree* const tree, const struct rebx_gr_full_arrays* const arr, const int first, const int count, const int depth){
+    const int c = tree->N_cells++;
+    struct rebx_gr_full_cell* const cell = &tree->cells[c];
+    const double* const coords[3] = {arr->x, arr->y, arr->z};
+    for (int k=0; k<3; k++){
+        cell->bmin[k] = coords[k][tree->idx[first]];
+        cell->bmax[k] = cell->bmin[k];
     }
-    for (int i=0; i<N; i++){
-        // then compute the constant terms:
-        double a_constx = 0.;
-        double a_consty = 0.;
-        double a_constz = 0.;
-        // 1st constant part
-        for (int j = 0; j< N; j++){
-            if (j != i){
-                const double dxij = ps_b[i].x - ps_b[j].x;
-                const double dyij = ps_b[i].y - ps_b[j].y;
-                const double dzij = ps_b[i].z - ps_b[j].z;
-                const double rij2 = dxij*dxij + dyij*dyij + dzij*dzij;
-                const double rij = sqrt(rij2);
-                const double rij3 = rij2*rij;
-                
-                double a1 = 0.;
-                for (int k = 0; k< N; k++){
-                    if (k != i){
-                        const double dxik = ps_b[i].x - ps_b[k].x;
-                        const double dyik = ps_b[i].y - ps_b[k].y;
-                        const double dzik = ps_b[i].z - ps_b[k].z;
-                        const double rik = sqrt(dxik*dxik + dyik*dyik + dzik*dzik);
-                        a1 += (4./(C2)) * G*particles[k].m/rik;
+    for (int n=first+1; n<first+count; n++){
+        for (int k=0; k<3; k++){
+            const double xk = coords[k][tree->idx[n]];
+            cell->bmin[k] = xk < cell->bmin[k] ? xk : cell->bmin[k];
+            cell->bmax[k] = xk > cell->bmax[k] ? xk : cell->bmax[k];
+        }
+    }
+    int axis = 0;
+    for (int k=1; k<3; k++){
+        if (cell->bmax[k] - cell->bmin[k] > cell->bmax[axis] - cell->bmin[axis]){
+            axis = k;
+        }
+    }
+    const double size = cell->bmax[axis] - cell->bmin[axis];
+    cell->size2 = size*size;
+    cell->first = first;
+    cell->count = count;
+    cell->child[0] = -1;
+    cell->child[1] = -1;
+    if (count <= REBX_GR_FULL_LEAF || size == 0. || depth >= REBX_GR_FULL_MAX_DEPTH){
+        return c;
+    }
+    const int half = count/2;
+    rebx_gr_full_select(tree->idx + first, count, half, coords[axis]);
+    cell->child[0] = rebx_gr_full_build(tree, arr, first, half, depth+1);
+    cell->child[1] = rebx_gr_full_build(tree, arr, first+half, count-half, depth+1);
+    return c;
+}
+
+enum rebx_gr_full_moments{
+    REBX_GR_FULL_MOMENTS_STATE,         // mass, center of mass and velocity moments
+    REBX_GR_FULL_MOMENTS_NEWTONIAN,     // potential sums and Newtonian accelerations
+    REBX_GR_FULL_MOMENTS_SUBSTITUTION,  // previous substitution
+};
+
+// Fills the cells' sums from the bodies in leaves and from the children otherwise, children first
+static void rebx_gr_full_moments(struct rebx_gr_full_tree* const tree, const struct rebx_gr_full_arrays* const arr, const enum rebx_gr_full_moments moments){
+    for (int c=tree->N_cells-1; c>=0; c--){
+        struct rebx_gr_full_cell* const cell = &tree->cells[c];
+        switch (moments){
+            case REBX_GR_FULL_MOMENTS_STATE:
+            {
+                double s[14] = {0.};  // M, m*x (3), m*v (3), m*v^2, m*v*v^T (6)
+                if (cell->child[0] < 0){
+                    for (int n=cell->first; n<cell->first+cell->count; n++){
+                        const int j = tree->idx[n];
+                        const double m = arr->m[j];
+                        const double v[3] = {arr->vx[j], arr->vy[j], arr->vz[j]};
+                        s[0] += m;
+                        s[1] += m*arr->x[j];
+                        s[2] += m*arr->y[j];
+                        s[3] += m*arr->z[j];
+                        s[4] += m*v[0];
+                        s[5] += m*v[1];
+                        s[6] += m*v[2];
+                        s[7] += m*(v[0]*v[0] + v[1]*v[1] + v[2]*v[2]);
+                        s[8] += m*v[0]*v[0];
+                        s[9] += m*v[0]*v[1];
+                        s[10] += m*v[0]*v[2];
+                        s[11] += m*v[1]*v[1];
+                        s[12] += m*v[1]*v[2];
+                        s[13] += m*v[2]*v[2];
+                    }
+                }
+                else{
+                    for (int k=0; k<2; k++){
+                        const struct rebx_gr_full_cell* const child = &tree->cells[cell->child[k]];
+                        s[0] += child->M;
+                        for (int l=0; l<3; l++){
+                            s[1+l] += child->M*child->com[l];
+                            s[4+l] += child->mv[l];
+                        }
+                        s[7] += child->mv2;
+                        for (int l=0; l<6; l++){
+                            s[8+l] += child->mvv[l];
+                        }
                     }
                 }
+                cell->M = s[0];
+                for (int l=0; l<3; l++){
+                    // Massless cells don't contribute, but keep their center well defined
+                    cell->com[l] = s[0] > 0. ? s[1+l]/s[0] : 0.5*(cell->bmin[l] + cell->bmax[l]);
+                    cell->mv[l] = s[4+l];
+                }
+                cell->mv2 = s[7];
+                for (int l=0; l<6; l++){
+                    cell->mvv[l] = s[8+l];
+                }
+                break;
+            }
+            case REBX_GR_FULL_MOMENTS_NEWTONIAN:
+            case REBX_GR_FULL_MOMENTS_SUBSTITUTION:
+            {
+                const double* const a = moments == REBX_GR_FULL_MOMENTS_NEWTONIAN ? arr->a_newt : arr->a_old;
+                double* const ma = moments == REBX_GR_FULL_MOMENTS_NEWTONIAN ? cell->ma : cell->msa;
+                double mphi = 0.;
+                ma[0] = 0.;
+                ma[1] = 0.;
+                ma[2] = 0.;
+                if (cell->child[0] < 0){
+                    for (int n=cell->first; n<cell->first+cell->count; n++){
+                        const int j = tree->idx[n];
+                        mphi += arr->m[j]*arr->phi[j];
+                        ma[0] += arr->m[j]*a[3*j];
+                        ma[1] += arr->m[j]*a[3*j+1];
+                        ma[2] += arr->m[j]*a[3*j+2];
+                    }
+                }
+                else{
+                    for (int k=0; k<2; k++){
+                        const struct rebx_gr_full_cell* const child = &tree->cells[cell->child[k]];
+                        const double* const child_ma = moments == REBX_GR_FULL_MOMENTS_NEWTONIAN ? child->ma : child->msa;
+                        mphi += child->mphi;
+                        ma[0] += child_ma[0];
+                        ma[1] += child_ma[1];
+                        ma[2] += child_ma[2];
+                    }
+                }
+                if (moments == REBX_GR_FULL_MOMENTS_NEWTONIAN){
+                    cell->mphi = mphi;
+                }
+                break;
+            }
+        }
+    }
+}
+
+enum rebx_gr_full_sum{
+    REBX_GR_FULL_SUM_NEWTONIAN,
+    REBX_GR_FULL_SUM_CONSTANT,
+    REBX_GR_FULL_SUM_SUBSTITUTE,
+};
 
-                double a2 = 0.;
-                for (int l = 0; l< N; l++){
-                    if (l != j){
-                        const double dxlj = ps_b[l].x - ps_b[j].x;
-                        const double dylj = ps_b[l].y - ps_b[j].y;
-                        const double dzlj = ps_b[l].z - ps_b[j].z;
-                        const double rlj = sqrt(dxlj*dxlj + dylj*dylj + dzlj*dzlj);
-                        a2 += (1./(C2)) * G*particles[l].m/rlj;
+static inline void rebx_gr_full_pair(const struct rebx_gr_full_arrays* const arr, const int i, const int j, const enum rebx_gr_full_sum sum, const double C2, const double G, const double vi2, double* const acc, double* const phi){
+    switch (sum){
+        case REBX_GR_FULL_SUM_NEWTONIAN:
+            rebx_gr_full_pair_newtonian(arr, i, j, G, acc, phi);
+            break;
+        case REBX_GR_FULL_SUM_CONSTANT:
+            rebx_gr_full_pair_constant(arr, i, j, C2, G, vi2, acc);
+            break;
+        case REBX_GR_FULL_SUM_SUBSTITUTE:
+            rebx_gr_full_pair_substitute(arr, i, j, C2, G, acc);
+            break;
+    }
+}
+
+// Sums one of the pair terms over all bodies j != i. Cells that are far enough away compared to their size
+// (and don't contain body i) are evaluated from their sums, the rest are opened down to individual bodies.
+static void rebx_gr_full_tree_sum(const struct rebx_gr_full_tree* const tree, const struct rebx_gr_full_arrays* const arr, const int i, const enum rebx_gr_full_sum sum, const double C2, const double G, double* const acc, double* const phi){
+    const double xi[3] = {arr->x[i], arr->y[i], arr->z[i]};
+    const double vi[3] = {arr->vx[i], arr->vy[i], arr->vz[i]};
+    const double vi2 = vi[0]*vi[0] + vi[1]*vi[1] + vi[2]*vi[2];
+    int stack[2*REBX_GR_FULL_MAX_DEPTH+2];
+    int N_stack = 0;
+    stack[N_stack++] = 0;
+    while (N_stack > 0){
+        const struct rebx_gr_full_cell* const cell = &tree->cells[stack[--N_stack]];
+        if (cell->M == 0.){
+            continue;
+        }
+        const double d[3] = {xi[0] - cell->com[0], xi[1] - cell->com[1], xi[2] - cell->com[2]};
+        const double r2 = d[0]*d[0] + d[1]*d[1] + d[2]*d[2];
+        const int contains_i = xi[0] >= cell->bmin[0] && xi[0] <= cell->bmax[0]
+                            && xi[1] >= cell->bmin[1] && xi[1] <= cell->bmax[1]
+                            && xi[2] >= cell->bmin[2] && xi[2] <= cell->bmax[2];
+        if (!contains_i && cell->size2 < tree->theta2*r2){
+            const double r = sqrt(r2);
+            const double r3 = r2*r;
+            switch (sum){
+                case REBX_GR_FULL_SUM_NEWTONIAN:
+                {
+                    const double prefac = G*cell->M/r3;
+                    acc[0] -= prefac*d[0];
+                    acc[1] -= prefac*d[1];
+                    acc[2] -= prefac*d[2];
+                    *phi += G*cell->M/r;
+                    break;
+                }
+                case REBX_GR_FULL_SUM_CONSTANT:
+                {
+                    const double* const mvv = cell->mvv;
+                    const double mvv_d[3] = {mvv[0]*d[0] + mvv[1]*d[1] + mvv[2]*d[2],
+                                             mvv[1]*d[0] + mvv[3]*d[1] + mvv[4]*d[2],
+                                             mvv[2]*d[0] + mvv[4]*d[1] + mvv[5]*d[2]};
+                    const double d_mvv_d = d[0]*mvv_d[0] + d[1]*mvv_d[1] + d[2]*mvv_d[2];
+                    const double vi_mv = vi[0]*cell->mv[0] + vi[1]*cell->mv[1] + vi[2]*cell->mv[2];
+                    const double d_vi = d[0]*vi[0] + d[1]*vi[1] + d[2]*vi[2];
+                    const double d_mv = d[0]*cell->mv[0] + d[1]*cell->mv[1] + d[2]*cell->mv[2];
+                    const double d_ma = d[0]*cell->ma[0] + d[1]*cell->ma[1] + d[2]*cell->ma[2];
+                    const double factor1 = cell->M*(4.*arr->phi[i] - vi2)/C2 + (cell->mphi - 2.*cell->mv2 + 4.*vi_mv)/C2
+                                         + (3./(2.*C2))*d_mvv_d/r2 + d_ma/(2.*C2);
+                    for (int k=0; k<3; k++){
+                        const double factor2 = 4.*d_vi*(cell->M*vi[k] - cell->mv[k]) - 3.*d_mv*vi[k] + 3.*mvv_d[k];
+                        acc[k] += G*d[k]*factor1/r3 + G/C2*(factor2/r3 + 7./2.*cell->ma[k]/r);
                     }
+                    break;
                 }
+                case REBX_GR_FULL_SUM_SUBSTITUTE:
+                {
+                    const double dotproduct = d[0]*cell->msa[0] + d[1]*cell->msa[1] + d[2]*cell->msa[2];
+                    for (int k=0; k<3; k++){
+                        acc[k] += (G*d[k]/r3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*cell->msa[k]/r;
+                    }
+                    break;
+                }
+            }
+        }
+        else if (cell->child[0] >= 0){
+            stack[N_stack++] = cell->child[1];
+            stack[N_stack++] = cell->child[0];
+        }
+        else{
+            for (int n=cell->first; n<cell->first+cell->count; n++){
+                const int j = tree->idx[n];
+                if (j == i){
+                    continue;
+                }
+                rebx_gr_full_pair(arr, i, j, sum, C2, G, vi2, acc, phi);
+            }
+        }
+    }
+}
 
-                double a3;
-                double vi2 = ps_b[i].vx*ps_b[i].vx + ps_b[i].vy*ps_b[i].vy + ps_b[i].vz*ps_b[i].vz;
-                a3 = -vi2/(C2);
+/*********************************
+ Sums over all pairs
+ ********************************/
 
-                double a4;
-                double vj2 = ps_b[j].vx*ps_b[j].vx + ps_b[j].vy*ps_b[j].vy + ps_b[j].vz*ps_b[j].vz;
-                a4 = -2.*vj2/(C2);
+// Which bodies act as sources of the pair terms. Test particles (from N_active on) only feel the active bodies. With
+// testparticle_type 1, test particles with mass also act on the active bodies, otherwise they are never sources.
+struct rebx_gr_full_sources{
+    int N_active;
+    int tests_are_sources;
+};
 
-                double a5;
-                a5 = (4./(C2)) * (ps_b[i].vx*ps_b[j].vx + ps_b[i].vy*ps_b[j].vy + ps_b[i].vz*ps_b[j].vz); 
-                
-                double a6;
-                double a6_0 = dxij*ps_b[j].vx + dyij*ps_b[j].vy + dzij*ps_b[j].vz;
-                a6 = (3./(2.*C2)) * a6_0*a6_0/rij2;
-               
-                double a7; // Newtonian piece of first ddot(r) piece
-                a7 = (dxij*ps_b[j].ax+dyij*ps_b[j].ay+dzij*ps_b[j].az)/(2.*C2);
-                
-                double factor1 = a1 + a2 + a3 + a4 + a5 + a6 + a7;
-                 
-                a_constx += G*particles[j].m*dxij*factor1/rij3;
-                a_consty += G*particles[j].m*dyij*factor1/rij3;
-                a_constz += G*particles[j].m*dzij*factor1/rij3;
-        
-                // 2nd constant part
-                
-                const double dvxij = ps_b[i].vx - ps_b[j].vx;
-                const double dvyij = ps_b[i].vy - ps_b[j].vy;
-                const double dvzij = ps_b[i].vz - ps_b[j].vz;
-                    
-                double factor2 = dxij*(4.*ps_b[i].vx-3.*ps_b[j].vx)+dyij*(4.*ps_b[i].vy-3.*ps_b[j].vy)+dzij*(4.*ps_b[i].vz-3.*ps_b[j].vz);
-
-                a_constx += G*particles[j].m/C2*(factor2*dvxij/rij3 + 7./2.*ps_b[j].ax/rij);
-                a_consty += G*particles[j].m/C2*(factor2*dvyij/rij3 + 7./2.*ps_b[j].ay/rij);
-                a_constz += G*particles[j].m/C2*(factor2*dvzij/rij3 + 7./2.*ps_b[j].az/rij);
+// Bodies j < returned index are the sources for body i
+static inline int rebx_gr_full_N_sources(const struct rebx_gr_full_sources* const sources, const int i, const int N){
+    return (sources->tests_are_sources && i < sources->N_active) ? N : sources->N_active;
+}
+
+// Sums one of the pair terms for every body i, over the tree if there is one, or directly otherwise. Each body only writes its own
+// sums, so bodies are processed in parallel without write conflicts. The results are written to out (3 per body), and to phi for
+// the Newtonian sum. Sums for each body run over its sources in order, so they don't depend on the tiling or the number of threads.
+static void rebx_gr_full_sum(const struct rebx_gr_full_tree* const tree, const struct rebx_gr_full_arrays* const arr, const int N, const struct rebx_gr_full_sources* const sources, const enum rebx_gr_full_sum sum, const double C2, const double G, double* const out){
+    const int N_blocks = (N + REBX_GR_FULL_BLOCK - 1)/REBX_GR_FULL_BLOCK;
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+    for (int b=0; b<N_blocks; b++){
+        const int i0 = b*REBX_GR_FULL_BLOCK;
+        const int i1 = i0 + REBX_GR_FULL_BLOCK < N ? i0 + REBX_GR_FULL_BLOCK : N;
+        for (int i=i0; i<i1; i++){
+            out[3*i] = 0.;
+            out[3*i+1] = 0.;
+            out[3*i+2] = 0.;
+            if (sum == REBX_GR_FULL_SUM_NEWTONIAN){
+                arr->phi[i] = 0.;
             }
-        }  
+        }
+        if (tree != NULL){
+            // The tree only holds the active bodies. Massive test particles are added directly
+            for (int i=i0; i<i1; i++){
+                rebx_gr_full_tree_sum(tree, arr, i, sum, C2, G, &out[3*i], &arr->phi[i]);
+                const double vi2 = sum == REBX_GR_FULL_SUM_CONSTANT ? arr->vx[i]*arr->vx[i] + arr->vy[i]*arr->vy[i] + arr->vz[i]*arr->vz[i] : 0.;
+                const int N_sources = rebx_gr_full_N_sources(sources, i, N);
+                for (int j=sources->N_active; j<N_sources; j++){
+                    if (j != i){
+                        rebx_gr_full_pair(arr, i, j, sum, C2, G, vi2, &out[3*i], &arr->phi[i]);
+                    }
+                }
+            }
+            continue;
+        }
+        if (i0 >= sources->N_active){
+            // Only test particles, which all feel the same few active bodies. Those are the outer loop, so the inner loop runs
+            // over contiguous test particles without dependencies
+            for (int j=0; j<sources->N_active; j++){
+                for (int i=i0; i<i1; i++){
+                    const double vi2 = sum == REBX_GR_FULL_SUM_CONSTANT ? arr->vx[i]*arr->vx[i] + arr->vy[i]*arr->vy[i] + arr->vz[i]*arr->vz[i] : 0.;
+                    rebx_gr_full_pair(arr, i, j, sum, C2, G, vi2, &out[3*i], &arr->phi[i]);
+                }
+            }
+            continue;
+        }
+        for (int j0=0; j0<N; j0+=REBX_GR_FULL_TILE){
+            for (int i=i0; i<i1; i++){
+                const int N_sources = rebx_gr_full_N_sources(sources, i, N);
+                const int j1 = j0 + REBX_GR_FULL_TILE < N_sources ? j0 + REBX_GR_FULL_TILE : N_sources;
+                double acc[3] = {out[3*i], out[3*i+1], out[3*i+2]};
+                double phi = arr->phi[i];
+                const double vi2 = sum == REBX_GR_FULL_SUM_CONSTANT ? arr->vx[i]*arr->vx[i] + arr->vy[i]*arr->vy[i] + arr->vz[i]*arr->vz[i] : 0.;
+                for (int j=j0; j<j1; j++){
+                    if (j == i){
+                        continue;
+                    }
+                    rebx_gr_full_pair(arr, i, j, sum, C2, G, vi2, acc, &phi);
+                }
+                out[3*i] = acc[0];
+                out[3*i+1] = acc[1];
+                out[3*i+2] = acc[2];
+                if (sum == REBX_GR_FULL_SUM_NEWTONIAN){
+                    arr->phi[i] = phi;
+                }
+            }
+        }
+    }
+}
+
+// theta is the opening angle of the tree, which is only used for at least N_direct active bodies (and theta > 0)
+static void rebx_calculate_gr_full(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N, const double C2, const double G, const int max_iterations, const int gravity_ignore_10, const double theta, const int N_direct){
+    struct rebx_gr_full_sources sources;
+    sources.N_active = (sim->N_active > 0 && sim->N_active < N) ? sim->N_active : N;
+    sources.tests_are_sources = 0;
+    if (sim->testparticle_type == 1){
+        for (int i=sources.N_active; i<N; i++){
+            if (particles[i].m != 0.){
+                sources.tests_are_sources = 1;
+                break;
+            }
+        }
+    }
+    struct rebx_gr_full_arrays arr;
+    struct rebx_gr_full_tree tree_storage;
+    struct rebx_gr_full_tree* const tree = (theta > 0. && sources.N_active >= N_direct && sources.N_active > 1) ? &tree_storage : NULL;
+    if (!rebx_gr_full_get_arrays(sim, force, N, &arr, tree)){
+        return;
+    }
+    for (int i=0; i<N; i++){
+        arr.x[i] = particles[i].x;
+        arr.y[i] = particles[i].y;
+        arr.z[i] = particles[i].z;
+        arr.m[i] = particles[i].m;
+    }
 
-        a_const[i][0] = a_constx;
-        a_const[i][1] = a_consty;
-        a_const[i][2] = a_constz;
+    // Calculate Newtonian accelerations and potentials (with the tree, from barycentric positions below), then transform to barycentric coordinates
+    const struct reb_particle com = reb_simulation_com(sim);
+    if (tree == NULL){
+        rebx_gr_full_sum(NULL, &arr, N, &sources, REBX_GR_FULL_SUM_NEWTONIAN, C2, G, arr.a_newt);
     }
-    for (int i = 0; i <N; i++){
-        ps_b[i].ax = a_const[i][0];
-        ps_b[i].ay = a_const[i][1];
-        ps_b[i].az = a_const[i][2];
+    for (int i=0; i<N; i++){
+        arr.x[i] = particles[i].x - com.x;
+        arr.y[i] = particles[i].y - com.y;
+        arr.z[i] = particles[i].z - com.z;
+        arr.vx[i] = particles[i].vx - com.vx;
+        arr.vy[i] = particles[i].vy - com.vy;
+        arr.vz[i] = particles[i].vz - com.vz;
     }
+    if (tree != NULL){
+        tree->theta2 = theta*theta;
+        tree->N_cells = 0;
+        for (int i=0; i<sources.N_active; i++){
+            tree->idx[i] = i;
+        }
+        rebx_gr_full_build(tree, &arr, 0, sources.N_active, 0);
+        rebx_gr_full_moments(tree, &arr, REBX_GR_FULL_MOMENTS_STATE);
+        rebx_gr_full_sum(tree, &arr, N, &sources, REBX_GR_FULL_SUM_NEWTONIAN, C2, G, arr.a_newt);
+        rebx_gr_full_moments(tree, &arr, REBX_GR_FULL_MOMENTS_NEWTONIAN);
+    }
+
+    // Terms that don't depend on the 1PN accelerations
+    rebx_gr_full_sum(tree, &arr, N, &sources, REBX_GR_FULL_SUM_CONSTANT, C2, G, arr.a_const);
+    memcpy(arr.a, arr.a_const, 3*N*sizeof(*arr.a));
 
-    // Now running the substitution again and again through the loop below
+    // Now running the substitution again and again through the loop below.
+    // Each pass only reads the previous one, so bodies can be updated in parallel
     for (int k=0; k<10; k++){ // you can set k as how many substitution you want to make
-        double a_old[N][3]; // initialize an arry that stores the information of previousu calculated accleration
-        for (int i =0; i <N; i++){
-            a_old[i][0] = ps_b[i].ax;
-            a_old[i][1] = ps_b[i].ay;
-            a_old[i][2] = ps_b[i].az;
+        double* const a_old = arr.a;
+        arr.a = arr.a_old;
+        arr.a_old = a_old;
+        if (tree != NULL){
+            rebx_gr_full_moments(tree, &arr, REBX_GR_FULL_MOMENTS_SUBSTITUTION);
         }
-        // now add on the non-constant term
-        for (int i = 0; i < N; i++){ // a_j is used to update a_i and vice versa
-            double non_constx = 0.;
-            double non_consty = 0.;
-            double non_constz = 0.;
-            for (int j = 0; j < N; j++){
-                if (j != i){
-                    const double dxij = ps_b[i].x - ps_b[j].x;
-                    const double dyij = ps_b[i].y - ps_b[j].y;
-                    const double dzij = ps_b[i].z - ps_b[j].z;
-                    const double rij = sqrt(dxij*dxij + dyij*dyij + dzij*dzij);
-                    const double rij3 = rij*rij*rij;
-                    const double dotproduct = dxij*ps_b[j].ax+dyij*ps_b[j].ay+dzij*ps_b[j].az;
-
-                    non_constx += (G*particles[j].m*dxij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*particles[j].m*ps_b[j].ax/rij;
-                    non_consty += (G*particles[j].m*dyij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*particles[j].m*ps_b[j].ay/rij;
-                    non_constz += (G*particles[j].m*dzij/rij3)*dotproduct/(2.*C2) + (7./(2.*C2))*G*particles[j].m*ps_b[j].az/rij;
-                }
-            }
-            ps_b[i].ax = a_const[i][0] + non_constx;
-            ps_b[i].ay = a_const[i][1] + non_consty;
-            ps_b[i].az = a_const[i][2] + non_constz;
+        rebx_gr_full_sum(tree, &arr, N, &sources, REBX_GR_FULL_SUM_SUBSTITUTE, C2, G, arr.a);
+        for (int i=0; i<3*N; i++){
+            arr.a[i] += arr.a_const[i];
         }
         
-        // break out loop if ps_b is converging
+        // break out loop if the accelerations are converging
         double maxdev = 0.;
-        double dx, dy, dz;
-        for (int i = 0; i < N; i++){
-            dx = (fabs(ps_b[i].ax) < DBL_EPSILON) ? 0. : fabs((ps_b[i].ax - a_old[i][0])/ps_b[i].ax);
-            dy = (fabs(ps_b[i].ay) < DBL_EPSILON) ? 0. : fabs((ps_b[i].ay - a_old[i][1])/ps_b[i].ay);
-            dz = (fabs(ps_b[i].az) < DBL_EPSILON) ? 0. : fabs((ps_b[i].az - a_old[i][2])/ps_b[i].az);
-            
-            if (dx > maxdev) { maxdev = dx; }
-            if (dy > maxdev) { maxdev = dy; }
-            if (dz > maxdev) { maxdev = dz; }
+        for (int i = 0; i < 3*N; i++){
+            const double d = (fabs(arr.a[i]) < DBL_EPSILON) ? 0. : fabs((arr.a[i] - arr.a_old[i])/arr.a[i]);
+            if (d > maxdev) { maxdev = d; }
         }
         
         if (maxdev < DBL_EPSILON){
             break;
         }
         if (k==9){
-            reb_simulation_warning(sim, "10 loops in rebx_gr_full did not converge.\n");
+            rebx_warning(sim->extras, "10 loops in rebx_gr_full did not converge.\n");
             fprintf(stderr, "Fractional Error: %e\n", maxdev);
         }
     }
    
     for (int i=0; i<N; i++){
-        particles[i].ax += ps_b[i].ax;
-        particles[i].ay += ps_b[i].ay;
-        particles[i].az += ps_b[i].az;
+        particles[i].ax += arr.a[3*i];
+        particles[i].ay += arr.a[3*i+1];
+        particles[i].az += arr.a[3*i+2];
     }
-    
-    free(ps_b);
-
 }
 
 void rebx_gr_full(struct reb_simulation* const sim, struct rebx_force* const gr_full, struct reb_particle* const particles, const int N){
     double* c = rebx_get_param(sim->extras, gr_full->ap, "c");
     if (c == NULL){
-        reb_simulation_error(sim, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
+        rebx_error(sim->extras, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
         return;
     }
     const double C2 = (*c)*(*c);
     const unsigned int gravity_ignore_10 = sim->gravity_ignore_terms==1;
     int* max_iterations = rebx_get_param(sim->extras, gr_full->ap, "max_iterations");
-    if(max_iterations != NULL){
-        rebx_calculate_gr_full(sim, particles, N, C2, sim->G, *max_iterations, gravity_ignore_10);
-    }
-    else{
-        const int default_max_iterations = 10;
-        rebx_calculate_gr_full(sim, particles, N, C2, sim->G, default_max_iterations, gravity_ignore_10);
-    }
+    double* theta = rebx_get_param(sim->extras, gr_full->ap, "gr_opening_angle");
+    int* N_direct = rebx_get_param(sim->extras, gr_full->ap, "gr_N_direct");
+    const int default_max_iterations = 10;
+    const int default_N_direct = 1000;
+    rebx_calculate_gr_full(sim, gr_full, particles, N, C2, sim->G, max_iterations != NULL ? *max_iterations : default_max_iterations, gravity_ignore_10,
+            theta != NULL ? *theta : 0., N_direct != NULL ? *N_direct : default_N_direct);
 }
 
 double rebx_gr_full_hamiltonian(struct rebx_extras* const rebx, const struct rebx_force* const force){
@@ -344,19 +758,29 @@ double rebx_gr_full_hamiltonian(struct rebx_extras* const rebx, const struct reb
         e_kin += 0.5*p.m*vtildei2;
     }
 
+    // Newtonian potential energy and the potential sums over k!=i of G*m_k/r_ik, one pass over the pairs
+    double* const phi = malloc(N*sizeof(*phi));
+    for (int i=0; i<N; i++){
+        phi[i] = 0.;
+    }
+    for (int i=0; i<N; i++){
+        const struct reb_particle pi = particles[i];
+        for (int j=i+1; j<N; j++){ // classic full
+            const struct reb_particle pj = particles[j];
+            const double dx = pi.x - pj.x;
+            const double dy = pi.y - pj.y;
+            const double dz = pi.z - pj.z;
+            const double r = sqrt(dx*dx + dy*dy + dz*dz);
+            
+            e_pot -= G*pi.m*pj.m/r;
+            phi[i] += G*pj.m/r;
+            phi[j] += G*pi.m/r;
+        }
+    }
+
     for (int i=0;i<N;i++){
         struct reb_particle pi = particles[i];
-        double sumk = 0.;
-        for (int k=0;k<N;k++){
-            if (k!=i){
-                struct reb_particle pk = particles[k];
-                double xik = pk.x - pi.x;
-                double yik = pk.y - pi.y;
-                double zik = pk.z - pi.z;
-                double rik = sqrt(xik*xik + yik*yik + zik*zik);
-                sumk -= 2.*G*pk.m/rik;
-            }
-        }
+        const double sumk = -2.*phi[i];
         
         double vtildei2 = vtilde[i].x*vtilde[i].x + vtilde[i].y*vtilde[i].y + vtilde[i].z*vtilde[i].z;
 
@@ -377,17 +801,11 @@ double rebx_gr_full_hamiltonian(struct rebx_extras* const rebx, const struct reb
         }
         
         e_pn -= pi.m/(8.*C2)*vtildei2*vtildei2;
-        
-        for (int j=i+1; j<N; j++){ // classic full
-            struct reb_particle pj = particles[j];
-            double dx = pi.x - pj.x;
-            double dy = pi.y - pj.y;
-            double dz = pi.z - pj.z;	
-            double r = sqrt(dx*dx + dy*dy + dz*dz);
-            
-            e_pot -= G*pi.m*pj.m/r;
-        }
     }
+
+    free(phi);
+    free(vtilde);
+    free(vtilde_old);
     
 	return e_kin + e_pot + e_pn;
 }
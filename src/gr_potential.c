@@ -57,10 +57,14 @@
 #include "rebound.h"
 #include "reboundx.h"
 
-static void rebx_calculate_gr_potential(struct reb_particle* const particles, const int N, const double C2, const double G){
+static void rebx_calculate_gr_potential(struct rebx_acc_buffers* const buffers, struct reb_particle* const particles, const int N, const double C2, const double G){
     const struct reb_particle source = particles[0];
     const double prefac1 = 6.*(G*source.m)*(G*source.m)/C2;
-    for (int i=1; i<N; i++){
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+    for (int b=0; b<buffers->N_blocks; b++){
+    int start, end;
+    double* const acc0 = rebx_block_acc(buffers, b, &start, &end); // back-reaction on particles[0]
+    for (int i=(start > 1 ? start : 1); i<end; i++){
         const struct reb_particle p = particles[i];
         const double dx = p.x - source.x;
         const double dy = p.y - source.y;
@@ -71,20 +75,26 @@ static void rebx_calculate_gr_potential(struct reb_particle* const particles, co
         particles[i].ax -= prefac*dx;
         particles[i].ay -= prefac*dy;
         particles[i].az -= prefac*dz;
-        particles[0].ax += p.m/source.m*prefac*dx;
-        particles[0].ay += p.m/source.m*prefac*dy;
-        particles[0].az += p.m/source.m*prefac*dz;
+        acc0[0] += p.m/source.m*prefac*dx;
+        acc0[1] += p.m/source.m*prefac*dy;
+        acc0[2] += p.m/source.m*prefac*dz;
     }
+    }
+    rebx_reduce_acc_buffers(buffers, particles, NULL);
 }
 
 void rebx_gr_potential(struct reb_simulation* const sim, struct rebx_force* const gr_potential, struct reb_particle* const particles, const int N){
     double* c = rebx_get_param(sim->extras, gr_potential->ap, "c");
     if (c == NULL){
-        reb_simulation_error(sim, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
+        rebx_error(sim->extras, "REBOUNDx Error: Need to set speed of light in gr effect.  See examples in documentation.\n");
     }
     else{
+        struct rebx_acc_buffers* const buffers = rebx_get_acc_buffers(sim->extras, gr_potential, 1, N);
+        if (buffers == NULL){
+            return;
+        }
         const double C2 = (*c)*(*c);
-        rebx_calculate_gr_potential(particles, N, C2, sim->G);
+        rebx_calculate_gr_potential(buffers, particles, N, C2, sim->G);
     }
 }
 
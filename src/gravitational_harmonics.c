@@ -136,22 +136,26 @@ static inline void uvw(struct reb_vec3d Omega, struct reb_vec3d* hatu, struct re
 void rebx_gravitational_harmonics(struct reb_simulation* const sim, struct rebx_force* const gh, struct reb_particle* const particles, const int N){
     const double G = sim->G;
     struct rebx_extras* const rebx = sim->extras;
+    const int J2_key = rebx_get_param_key(rebx, "J2");
+    const int J4_key = rebx_get_param_key(rebx, "J4");
+    const int R_eq_key = rebx_get_param_key(rebx, "R_eq");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
 
     for (int i=0; i<N; i++){
-        const double* const J2 = rebx_get_param(rebx, particles[i].ap, "J2");
+        const double* const J2 = rebx_get_param_by_key(rebx, particles[i].ap, J2_key);
         if (J2 == NULL){
             continue;
         }
         if (*J2 == 0.0){
             continue;
         }
-        const double* const J4 = rebx_get_param(rebx, particles[i].ap, "J4");
-        const double* const R_eq = rebx_get_param(rebx, particles[i].ap, "R_eq");
+        const double* const J4 = rebx_get_param_by_key(rebx, particles[i].ap, J4_key);
+        const double* const R_eq = rebx_get_param_by_key(rebx, particles[i].ap, R_eq_key);
         if (R_eq == NULL){
             continue;
         }
         struct reb_vec3d Omega = DEFAULTOMEGA;
-        const struct reb_vec3d* Omegaptr = rebx_get_param(rebx, particles[i].ap, "Omega");
+        const struct reb_vec3d* Omegaptr = rebx_get_param_by_key(rebx, particles[i].ap, Omega_key);
         if (Omegaptr != NULL){
             Omega.x = Omegaptr->x;
             Omega.y = Omegaptr->y;
@@ -181,7 +185,15 @@ void rebx_gravitational_harmonics(struct reb_simulation* const sim, struct rebx_
         hatz_.y = hatv.z;
         hatz_.z = hatw.z;
 
-        for (int j=0; j<N; j++){
+        struct rebx_acc_buffers* const buffers = rebx_get_acc_buffers(rebx, gh, 1, N);
+        if (buffers == NULL){
+            return;
+        }
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+        for (int b=0; b<buffers->N_blocks; b++){
+        int start, end;
+        double* const acc_i = rebx_block_acc(buffers, b, &start, &end); // back-reaction on particles[i]
+        for (int j=start; j<end; j++){
             if (j == i){
                 continue;
             }
@@ -218,10 +230,12 @@ void rebx_gravitational_harmonics(struct reb_simulation* const sim, struct rebx_
 
             const double fac = pj.m/pi.m;
 
-            particles[i].ax -= fac*ax;
-            particles[i].ay -= fac*ay;
-            particles[i].az -= fac*az;
+            acc_i[0] -= fac*ax;
+            acc_i[1] -= fac*ay;
+            acc_i[2] -= fac*az;
+        }
         }
+        rebx_reduce_acc_buffers(buffers, particles, &i);
     }
 }
 
@@ -261,22 +275,26 @@ double rebx_gravitational_harmonics_potential(struct rebx_extras* const rebx){
     const double G = sim->G;
     const int N = sim->N - sim->N_var;
     double H = 0.0;
+    const int J2_key = rebx_get_param_key(rebx, "J2");
+    const int J4_key = rebx_get_param_key(rebx, "J4");
+    const int R_eq_key = rebx_get_param_key(rebx, "R_eq");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
 
     for (int i=0; i<N; i++){
-        const double* const J2 = rebx_get_param(rebx, particles[i].ap, "J2");
+        const double* const J2 = rebx_get_param_by_key(rebx, particles[i].ap, J2_key);
         if (J2 == NULL){
             continue;
         }
         if (*J2 == 0.0){
             continue;
         }
-        const double* const J4 = rebx_get_param(rebx, particles[i].ap, "J4");
-        const double* const R_eq = rebx_get_param(rebx, particles[i].ap, "R_eq");
+        const double* const J4 = rebx_get_param_by_key(rebx, particles[i].ap, J4_key);
+        const double* const R_eq = rebx_get_param_by_key(rebx, particles[i].ap, R_eq_key);
         if (R_eq == NULL){
             continue;
         }
         struct reb_vec3d Omega = DEFAULTOMEGA;
-        const struct reb_vec3d* Omegaptr = rebx_get_param(rebx, particles[i].ap, "Omega");
+        const struct reb_vec3d* Omegaptr = rebx_get_param_by_key(rebx, particles[i].ap, Omega_key);
         if (Omegaptr != NULL){
             Omega.x = Omegaptr->x;
             Omega.y = Omegaptr->y;
@@ -50,6 +50,7 @@ else{\
 if(!fread(valueref, field.size, 1, inf)){\
 *warnings |= REBX_INPUT_BINARY_ERROR_CORRUPT;\
 free(valueref);\
+valueref = NULL;\
 }\
 }\
 break;\
@@ -61,7 +62,7 @@ void rebx_input_skip_binary_field(FILE* inf, long field_size){
 
 static int rebx_load_list(struct rebx_extras* rebx, enum rebx_binary_field_type expected_type, struct rebx_node** ap, FILE* inf, enum rebx_input_binary_messages* warnings);
 
-static struct rebx_param* rebx_read_param(struct rebx_extras* rebx, FILE* inf, enum rebx_input_binary_messages* warnings){
+static struct rebx_param* rebx_read_param(struct rebx_extras* rebx, FILE* inf, long* value_size, enum rebx_input_binary_messages* warnings){
     
     struct rebx_param* param = malloc(sizeof(*param));
     if (param == NULL){
@@ -71,6 +72,9 @@ static struct rebx_param* rebx_read_param(struct rebx_extras* rebx, FILE* inf, e
     param->value = NULL;
     param->name = NULL;
     param->type = REBX_TYPE_NONE;
+    param->key = -1;
+    param->length = 0;
+    param->pooled = 0;
     
     struct rebx_binary_field field;
     int reading_fields = 1;
@@ -79,6 +83,9 @@ static struct rebx_param* rebx_read_param(struct rebx_extras* rebx, FILE* inf, e
             *warnings |= REBX_INPUT_BINARY_ERROR_CORRUPT;
             break;
         }
+        if (field.type == REBX_BINARY_FIELD_TYPE_PARAM_VALUE){
+            *value_size = field.size;
+        }
         switch (field.type){
             CASE(PARAM_TYPE,                  &param->type);
             CASE_MALLOC(NAME,                 param->name);
@@ -99,11 +106,15 @@ static struct rebx_param* rebx_read_param(struct rebx_extras* rebx, FILE* inf, e
         rebx_free_param(param);
         return NULL;
     }
+    if (param->type == REBX_TYPE_DOUBLE_ARRAY || param->type == REBX_TYPE_INT_ARRAY){
+        param->length = *value_size/rebx_sizeof(rebx, param->type);
+    }
     return param;
 }
 
 static int rebx_load_param(struct rebx_extras* rebx, struct rebx_node** ap, FILE* inf, enum rebx_input_binary_messages* warnings){
-    struct rebx_param* param = rebx_read_param(rebx, inf, warnings);
+    long value_size = 0;
+    struct rebx_param* param = rebx_read_param(rebx, inf, &value_size, warnings);
     
     if(param == NULL){
         return 0;
@@ -122,27 +133,64 @@ static int rebx_load_param(struct rebx_extras* rebx, struct rebx_node** ap, FILE
             rebx_free_param(param);
             return 0;
         }
+        free(param->value); // force name
         param->value = force;
     }
-    int success = rebx_add_param(rebx, ap, param);
-    if(!success){
+
+    const int key = rebx_get_param_key(rebx, param->name);
+    const size_t inline_size = rebx_param_value_size(param->type);
+    if (key < 0 || rebx_get_registered_param(rebx, key)->type != param->type || (inline_size && value_size < (long)inline_size)){ // keep the loaded param as is
+        int success = rebx_add_param(rebx, ap, param);
+        if(!success){
+            return 0;
+        }
+        return 1;
+    }
+
+    struct rebx_param* stored = rebx_add_param_by_key(rebx, ap, key);
+    if (stored == NULL){
+        *warnings |= REBX_INPUT_BINARY_ERROR_NO_MEMORY;
+        if (param->type == REBX_TYPE_FORCE){
+            param->value = NULL;
+        }
+        rebx_free_param(param);
         return 0;
     }
+    if (stored->value != NULL){ // copy into inline storage
+        memcpy(stored->value, param->value, inline_size);
+        free(param->value);
+    }
+    else{
+        stored->value = param->value;
+        stored->length = param->length;
+    }
+    param->value = NULL;
+    rebx_free_param(param);
     return 1;
-    
 }
 
 static int rebx_load_registered_param(struct rebx_extras* rebx, FILE* inf, enum rebx_input_binary_messages* warnings){
-    struct rebx_param* param = rebx_read_param(rebx, inf, warnings);
+    long value_size = 0;
+    struct rebx_param* param = rebx_read_param(rebx, inf, &value_size, warnings);
     
     if(param == NULL){
         return 0;
     }
     
+    const enum rebx_param_type reg_type = rebx_get_type(rebx, param->name);
+    if(reg_type != REBX_TYPE_NONE){ // already registered (e.g. default params)
+        const int same_type = (reg_type == param->type);
+        rebx_free_param(param);
+        return same_type;
+    }
+
     int success = rebx_add_param(rebx, &rebx->registered_params, param);
     if(!success){
         return 0;
     }
+    if(rebx_intern_param(rebx, param) < 0){
+        return 0;
+    }
     return 1;
 }
 
@@ -642,17 +690,41 @@ void rebx_init_extras_from_binary(struct rebx_extras* rebx, const char* const fi
     return;
 }
 
-struct rebx_extras* rebx_create_extras_from_binary(struct reb_simulation* sim, const char* const filename){
-    if (sim == NULL){
-        fprintf(stderr, "REBOUNDx Error: Simulation pointer passed to rebx_create_extras_from_binary was NULL.\n");
-        return NULL;
+void rebx_init_extras_from_buffer(struct rebx_extras* rebx, const char* const buf, const size_t size, enum rebx_input_binary_messages* warnings){
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return;
     }
-    enum rebx_input_binary_messages warnings = REBX_INPUT_BINARY_WARNING_NONE;
-    // create manually so that default registered parameters not loaded
-    struct rebx_extras* rebx = malloc(sizeof(*rebx));
-    rebx_initialize(sim, rebx);
-    rebx_init_extras_from_binary(rebx, filename, &warnings);
+    if (buf == NULL || size == 0){
+        *warnings |= REBX_INPUT_BINARY_ERROR_CORRUPT;
+        return;
+    }
+#ifdef _WIN32
+    FILE* inf = tmpfile(); // No memory streams on Windows, so go through a temporary file
+    if (inf && fwrite(buf, 1, size, inf) != size){
+        fclose(inf);
+        inf = NULL;
+    }
+    if (inf){
+        rewind(inf);
+    }
+#else
+    FILE* inf = fmemopen((void*)buf, size, "rb");
+#endif
+    if (!inf){
+        *warnings |= REBX_INPUT_BINARY_ERROR_NO_MEMORY;
+        return;
+    }
+    
+    rebx_input_read_header(inf, warnings);
+    rebx_load_snapshot(rebx, inf, warnings);
     
+    fclose(inf);
+    return;
+}
+
+// Reports the messages raised while loading a binary through the simulation
+static void rebx_input_report_messages(struct reb_simulation* sim, const enum rebx_input_binary_messages warnings){
     if (warnings & REBX_INPUT_BINARY_ERROR_NOFILE){
         reb_simulation_error(sim,"REBOUNDx: Cannot open binary file. Check filename.");
     }
@@ -701,6 +773,32 @@ struct rebx_extras* rebx_create_extras_from_binary(struct reb_simulation* sim, c
     if (warnings & REBX_INPUT_BINARY_WARNING_FORCE_PARAM_NOT_LOADED){
         reb_simulation_warning(sim,"REBOUNDx: A force parameter failed to load from the list of REBOUNDx implemented forces. Custom forces can't be saved to a REBOUNDx binary, and function points must be reset when a simulation is reloaded.");
     }
+}
+
+struct rebx_extras* rebx_create_extras_from_binary(struct reb_simulation* sim, const char* const filename){
+    if (sim == NULL){
+        fprintf(stderr, "REBOUNDx Error: Simulation pointer passed to rebx_create_extras_from_binary was NULL.\n");
+        return NULL;
+    }
+    enum rebx_input_binary_messages warnings = REBX_INPUT_BINARY_WARNING_NONE;
+    // create manually so that default registered parameters not loaded
+    struct rebx_extras* rebx = malloc(sizeof(*rebx));
+    rebx_initialize(sim, rebx);
+    rebx_init_extras_from_binary(rebx, filename, &warnings);
+    rebx_input_report_messages(sim, warnings);
+    return rebx;
+}
+
+struct rebx_extras* rebx_create_extras_from_buffer(struct reb_simulation* sim, const char* const buf, const size_t size){
+    if (sim == NULL){
+        fprintf(stderr, "REBOUNDx Error: Simulation pointer passed to rebx_create_extras_from_buffer was NULL.\n");
+        return NULL;
+    }
+    enum rebx_input_binary_messages warnings = REBX_INPUT_BINARY_WARNING_NONE;
+    struct rebx_extras* rebx = malloc(sizeof(*rebx));
+    rebx_initialize(sim, rebx);
+    rebx_init_extras_from_buffer(rebx, buf, size, &warnings);
+    rebx_input_report_messages(sim, warnings);
     return rebx;
 }
 
@@ -138,6 +138,16 @@ void rebx_init_interpolator(struct rebx_extras* const rebx, struct rebx_interpol
     memcpy(interp->values, values, Nvalues*sizeof(*interp->values));
     interp->y2 = NULL;
     interp->klo = 0;
+    interp->refcount = rebx_malloc(rebx, sizeof(*interp->refcount));
+    if (interp->refcount == NULL){
+        free(interp->times);
+        free(interp->values);
+        interp->times = NULL;
+        interp->values = NULL;
+        interp->Nvalues = 0;
+        return;
+    }
+    *interp->refcount = 1;
     if (interpolation == REBX_INTERPOLATION_SPLINE){
         interp->y2 = rebx_malloc(rebx, Nvalues*sizeof(*interp->y2));
         rebx_spline(interp->times, interp->values, interp->Nvalues, interp->y2);
@@ -145,7 +155,31 @@ void rebx_init_interpolator(struct rebx_extras* const rebx, struct rebx_interpol
     return;
 }
 
+// The tables are read-only after initialization, so copies share them and only carry their own klo
+struct rebx_interpolator* rebx_share_interpolator(struct rebx_extras* const rebx, struct rebx_interpolator* const interpolator){
+    if (interpolator->refcount == NULL){
+        return rebx_create_interpolator(rebx, interpolator->Nvalues, interpolator->times, interpolator->values, interpolator->interpolation);
+    }
+    struct rebx_interpolator* interp = rebx_malloc(rebx, sizeof(*interp));
+    if (interp == NULL){
+        return NULL;
+    }
+    *interp = *interpolator;
+#pragma omp atomic
+    (*interpolator->refcount)++;
+    return interp;
+}
+
 void rebx_free_interpolator_pointers(struct rebx_interpolator* const interpolator){
+    if (interpolator->refcount != NULL){
+        int refcount;
+#pragma omp atomic capture
+        refcount = --(*interpolator->refcount);
+        if (refcount > 0){
+            return;
+        }
+        free(interpolator->refcount);
+    }
     free(interpolator->times); 
     free(interpolator->values);
     if (interpolator->y2 != NULL){
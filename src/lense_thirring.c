@@ -62,11 +62,15 @@
 #include "rebound.h"
 #include "reboundx.h"
 
-static void rebx_calculate_LT_force(struct reb_simulation* const sim, struct reb_particle* const particles, const int N, const struct reb_vec3d Omega, const double I, const double C2){
+static void rebx_calculate_LT_force(struct reb_simulation* const sim, struct rebx_acc_buffers* const buffers, struct reb_particle* const particles, const int N, const struct reb_vec3d Omega, const double I, const double C2){
     const double G = sim->G;
     const double gamma = 1.000021;   //hard-coded Eddington-Robertson-Shiff parameter for now
     const struct reb_particle source = particles[0]; // hard-code particles[0] as source particle
-    for (int i=1; i<N; i++){
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+    for (int b=0; b<buffers->N_blocks; b++){
+    int start, end;
+    double* const acc0 = rebx_block_acc(buffers, b, &start, &end); // back-reaction on particles[0]
+    for (int i=(start > 1 ? start : 1); i<end; i++){
         const struct reb_particle p = particles[i];
         const double dx = p.x - source.x;
         const double dy = p.y - source.y;
@@ -93,17 +97,20 @@ static void rebx_calculate_LT_force(struct reb_simulation* const sim, struct reb
         particles[i].ax += 2.*(Omega_y*dvz - Omega_z*dvy);
         particles[i].ay += 2.*(Omega_z*dvx - Omega_x*dvz);
         particles[i].az += 2.*(Omega_x*dvy - Omega_y*dvx);
-        particles[0].ax -= mratio * 2. * (Omega_y*dvz - Omega_z*dvy); 
-        particles[0].ay -= mratio * 2. * (Omega_z*dvx - Omega_x*dvz);
-        particles[0].az -= mratio * 2. * (Omega_x*dvy - Omega_y*dvx);
+        acc0[0] -= mratio * 2. * (Omega_y*dvz - Omega_z*dvy); 
+        acc0[1] -= mratio * 2. * (Omega_z*dvx - Omega_x*dvz);
+        acc0[2] -= mratio * 2. * (Omega_x*dvy - Omega_y*dvx);
     }
+    }
+    rebx_reduce_acc_buffers(buffers, particles, NULL);
 }
 
 void rebx_lense_thirring(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N){
     struct rebx_extras* const rebx = sim->extras;
     double* c = rebx_get_param(sim->extras, force->ap, "lt_c");
     if (c == NULL){
-        reb_simulation_error(sim, "REBOUNDx Error: Need to set speed of light in LT effect.  See examples in documentation.\n");
+        rebx_error(sim->extras, "REBOUNDx Error: Need to set speed of light in LT effect.  See examples in documentation.\n");
+        return;
     }
     const double C2 = (*c)*(*c);
 
@@ -111,7 +118,11 @@ void rebx_lense_thirring(struct reb_simulation* const sim, struct rebx_force* co
     if (I != NULL){
         const struct reb_vec3d* Omega  = rebx_get_param(rebx, particles[0].ap, "Omega");
         if(Omega != NULL){
-            rebx_calculate_LT_force(sim, particles, N, *Omega, *I, C2);
+            struct rebx_acc_buffers* const buffers = rebx_get_acc_buffers(rebx, force, 1, N);
+            if (buffers == NULL){
+                return;
+            }
+            rebx_calculate_LT_force(sim, buffers, particles, N, *Omega, *I, C2);
         }
     }
 }
@@ -62,9 +62,10 @@
 
 void rebx_modify_mass(struct reb_simulation* const sim, struct rebx_operator* const operator, const double dt){
     const int _N_real = sim->N - sim->N_var;
+    const int tau_mass_key = rebx_get_param_key(sim->extras, "tau_mass");
 	for(int i=0; i<_N_real; i++){
 		struct reb_particle* const p = &sim->particles[i];
-        const double* const tau_mass = rebx_get_param(sim->extras, p->ap, "tau_mass");
+        const double* const tau_mass = rebx_get_param_by_key(sim->extras, p->ap, tau_mass_key);
         if (tau_mass != NULL){
 		    p->m += p->m*dt/(*tau_mass);
         }
@@ -80,24 +80,36 @@
 #include "rebxtools.h"
 
 
-static struct reb_particle rebx_calculate_modify_orbits_direct(struct reb_simulation* const sim, struct rebx_operator* const operator, struct reb_particle* p, struct reb_particle* primary, const double dt){
+struct rebx_modify_orbits_direct_keys{
+    int tau_a;
+    int tau_e;
+    int tau_inc;
+    int tau_omega;
+    int tau_Omega;
+    int ide_position;
+    int ide_width;
+    int p;
+};
+
+static struct reb_particle rebx_calculate_modify_orbits_direct(struct reb_simulation* const sim, struct rebx_operator* const operator, struct reb_particle* p, struct reb_particle* primary, const double dt, const void* const keys_ptr){
     struct rebx_extras* const rebx = sim->extras;
+    const struct rebx_modify_orbits_direct_keys* const keys = keys_ptr;
     int err=0;
     struct reb_orbit o = reb_orbit_from_particle_err(sim->G, *p, *primary, &err);
     if(err){        // mass of primary was 0 or p = primary.  Return same particle without doing anything.
         return *p;
     } 
 
-    const double* const tau_a_ptr = rebx_get_param(rebx, p->ap, "tau_a");
-    const double* const tau_e = rebx_get_param(rebx, p->ap, "tau_e");
-    const double* const tau_inc = rebx_get_param(rebx, p->ap, "tau_inc");
-    const double* const tau_omega = rebx_get_param(rebx, p->ap, "tau_omega");
-    const double* const tau_Omega = rebx_get_param(rebx, p->ap, "tau_Omega");
+    const double* const tau_a_ptr = rebx_get_param_by_key(rebx, p->ap, keys->tau_a);
+    const double* const tau_e = rebx_get_param_by_key(rebx, p->ap, keys->tau_e);
+    const double* const tau_inc = rebx_get_param_by_key(rebx, p->ap, keys->tau_inc);
+    const double* const tau_omega = rebx_get_param_by_key(rebx, p->ap, keys->tau_omega);
+    const double* const tau_Omega = rebx_get_param_by_key(rebx, p->ap, keys->tau_Omega);
 
     //Implement the planet trap
     double invtau_a = 0.0;   
-    const double* const dedge = rebx_get_param(sim->extras, operator->ap, "ide_position");
-    const double* const hedge = rebx_get_param(sim->extras, operator->ap, "ide_width");
+    const double* const dedge = rebx_get_param_by_key(sim->extras, operator->ap, keys->ide_position);
+    const double* const hedge = rebx_get_param_by_key(sim->extras, operator->ap, keys->ide_width);
     
     const double a0 = o.a;
     const double e0 = o.e;
@@ -124,7 +136,7 @@ static struct reb_particle rebx_calculate_modify_orbits_direct(struct reb_simula
 	}
    
     if(tau_e != NULL){
-        const double* const p_param = rebx_get_param(sim->extras, operator->ap, "p");
+        const double* const p_param = rebx_get_param_by_key(sim->extras, operator->ap, keys->p);
         if(p_param != NULL){
 			o.a += 2.*a0*e0*e0*(*p_param)*dt/(*tau_e); // Coupling term between e and a
 		}
@@ -140,5 +152,15 @@ void rebx_modify_orbits_direct(struct reb_simulation* const sim, struct rebx_ope
 	}
     const int back_reactions_inclusive = 1;
     const char* reference_name = "primary";
-    rebx_tools_com_ptm(sim, operator, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_direct, dt);
+    const struct rebx_modify_orbits_direct_keys keys = {
+        .tau_a = rebx_get_param_key(sim->extras, "tau_a"),
+        .tau_e = rebx_get_param_key(sim->extras, "tau_e"),
+        .tau_inc = rebx_get_param_key(sim->extras, "tau_inc"),
+        .tau_omega = rebx_get_param_key(sim->extras, "tau_omega"),
+        .tau_Omega = rebx_get_param_key(sim->extras, "tau_Omega"),
+        .ide_position = rebx_get_param_key(sim->extras, "ide_position"),
+        .ide_width = rebx_get_param_key(sim->extras, "ide_width"),
+        .p = rebx_get_param_key(sim->extras, "p"),
+    };
+    rebx_tools_com_ptm(sim, operator, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_direct, &keys, dt);
 }
@@ -74,18 +74,27 @@
 #include "reboundx.h"
 #include "rebxtools.h"
 
-static struct reb_vec3d rebx_calculate_modify_orbits_forces(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source){
+struct rebx_modify_orbits_forces_keys{
+    int tau_a;
+    int tau_e;
+    int tau_inc;
+    int ide_position;
+    int ide_width;
+};
+
+static struct reb_vec3d rebx_calculate_modify_orbits_forces(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source, const void* const keys_ptr){
+    const struct rebx_modify_orbits_forces_keys* const keys = keys_ptr;
     double invtau_a = 0.0;
     double tau_e = INFINITY;
     double tau_inc = INFINITY;
     
-    const double* const tau_a_ptr = rebx_get_param(sim->extras, p->ap, "tau_a");
-    const double* const tau_e_ptr = rebx_get_param(sim->extras, p->ap, "tau_e");
-    const double* const tau_inc_ptr = rebx_get_param(sim->extras, p->ap, "tau_inc");
+    const double* const tau_a_ptr = rebx_get_param_by_key(sim->extras, p->ap, keys->tau_a);
+    const double* const tau_e_ptr = rebx_get_param_by_key(sim->extras, p->ap, keys->tau_e);
+    const double* const tau_inc_ptr = rebx_get_param_by_key(sim->extras, p->ap, keys->tau_inc);
 
     //Implement the planet trap
-    const double* const dedge = rebx_get_param(sim->extras, force->ap, "ide_position");
-    const double* const hedge = rebx_get_param(sim->extras, force->ap, "ide_width");
+    const double* const dedge = rebx_get_param_by_key(sim->extras, force->ap, keys->ide_position);
+    const double* const hedge = rebx_get_param_by_key(sim->extras, force->ap, keys->ide_width);
 
     const double dvx = p->vx - source->vx;
     const double dvy = p->vy - source->vy;
@@ -135,5 +144,12 @@ void rebx_modify_orbits_forces(struct reb_simulation* const sim, struct rebx_for
     }
     const int back_reactions_inclusive = 1;
     const char* reference_name = "primary";
-    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_forces, particles, N);
+    const struct rebx_modify_orbits_forces_keys keys = {
+        .tau_a = rebx_get_param_key(sim->extras, "tau_a"),
+        .tau_e = rebx_get_param_key(sim->extras, "tau_e"),
+        .tau_inc = rebx_get_param_key(sim->extras, "tau_inc"),
+        .ide_position = rebx_get_param_key(sim->extras, "ide_position"),
+        .ide_width = rebx_get_param_key(sim->extras, "ide_width"),
+    };
+    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_forces, &keys, particles, N);
 }
@@ -24,6 +24,7 @@
  */
 
 #include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include "reboundx.h"
 #include "core.h"
@@ -110,7 +111,7 @@ long pos_end_##name = ftell(of);\
 header_##name.size = pos_end_##name - pos_start_##name;\
 fseek(of, pos_start_header_##name, SEEK_SET);\
 fwrite(&header_##name, sizeof(header_##name), 1, of);\
-fseek(of, 0, SEEK_END);\
+fseek(of, pos_end_##name, SEEK_SET);\
 }
 
 /*  Write a list of listtype (e.g., ALLOCATED_FORCES) with nodes of type nodetype (e.g. ALLOCATED_FORCE), to the passed linkedlist (e.g. rebx->allocated_forces)*/
@@ -136,6 +137,13 @@ static void rebx_write_param(struct rebx_extras* rebx, struct rebx_param* param,
     if (param->type == REBX_TYPE_POINTER){ // Don't write pointers because we won't know how to load them when we read binary. Need to add type to store in binaries.
         return;
     }
+    size_t value_size = rebx_sizeof(rebx, param->type);
+    if (param->type == REBX_TYPE_DOUBLE_ARRAY || param->type == REBX_TYPE_INT_ARRAY){ // length is recovered from the field size when reading
+        if (param->length == 0){
+            return;
+        }
+        value_size *= param->length;
+    }
     
     if (param->type == REBX_TYPE_FORCE){ // Force already written to allocated_force list. For parce PARAMETERS we agree to store force name in param->value so that the reallocated force can be linked up when we read binary
         rebx_write_force_param(rebx, param, of);
@@ -144,7 +152,7 @@ static void rebx_write_param(struct rebx_extras* rebx, struct rebx_param* param,
     REBX_START_OBJECT_FIELD(param, PARAM);
     REBX_WRITE_DATA_FIELD(PARAM_TYPE, &param->type,     sizeof(param->type));
     REBX_WRITE_DATA_FIELD(NAME,       param->name,      strlen(param->name) + 1);
-    REBX_WRITE_DATA_FIELD(PARAM_VALUE,      param->value,     rebx_sizeof(rebx, param->type));
+    REBX_WRITE_DATA_FIELD(PARAM_VALUE,      param->value,     value_size);
     REBX_END_OBJECT_FIELD(param);
 }
 
@@ -155,6 +163,15 @@ static void rebx_write_registered_param(struct rebx_extras* rebx, struct rebx_pa
     REBX_END_OBJECT_FIELD(registered_param);
 }
 
+// Default params are written too, so that binaries stay readable by versions that expect them in the file. Written in key order, i.e. order of registration
+static void rebx_write_registered_params(struct rebx_extras* rebx, FILE* of){
+    REBX_START_OBJECT_FIELD(list, REGISTERED_PARAMETERS);
+    for (int key=0; key<rebx->N_param_keys; key++){
+        rebx_write_registered_param(rebx, rebx_get_registered_param(rebx, key), of);
+    }
+    REBX_END_OBJECT_FIELD(list);
+}
+
 static void rebx_write_force(struct rebx_extras* rebx, struct rebx_force* force, FILE* of){
     REBX_START_OBJECT_FIELD(force, FORCE);
     // must write name first so that force can be loaded on read
@@ -194,7 +211,7 @@ static void rebx_write_particle(struct rebx_extras* rebx, struct reb_particle* p
 
 static void rebx_write_rebx(struct rebx_extras* rebx, FILE* of){
     REBX_START_OBJECT_FIELD(rebx_structure, REBX_STRUCTURE);
-    REBX_WRITE_LIST_FIELD(REGISTERED_PARAMETERS, REGISTERED_PARAM, rebx->registered_params);
+    rebx_write_registered_params(rebx, of);
     REBX_WRITE_LIST_FIELD(ALLOCATED_FORCES, FORCE, rebx->allocated_forces);
     REBX_WRITE_LIST_FIELD(ALLOCATED_OPERATORS, OPERATOR, rebx->allocated_operators);
     REBX_WRITE_LIST_FIELD(ADDITIONAL_FORCES, ADDITIONAL_FORCE, rebx->additional_forces);
@@ -269,15 +286,8 @@ static void rebx_write_snapshot(struct rebx_extras* rebx, FILE* of){
     REBX_END_OBJECT_FIELD(snapshot);
 }
 
-void rebx_output_binary(struct rebx_extras* rebx, char* filename){
-    FILE* of = fopen(filename,"wb");
-    if (of==NULL){
-        rebx_error(rebx, "REBOUNDx error: Can not open file passed to rebx_output_binary.");
-    }
-    if (rebx->sim == NULL){
-        rebx_error(rebx, ""); // rebx_error gives meaningful err
-        return;
-    }
+// Writes the header and a snapshot to an open stream
+static void rebx_write_binary(struct rebx_extras* rebx, FILE* of){
     // Write header.
     const char str[] = "REBOUNDx Binary File. Version: ";
     char zero = '\0';
@@ -289,5 +299,55 @@ void rebx_output_binary(struct rebx_extras* rebx, char* filename){
     fwrite(&zero,sizeof(char),1,of);
 
     rebx_write_snapshot(rebx, of);
+}
+
+void rebx_output_binary(struct rebx_extras* rebx, char* filename){
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return;
+    }
+    FILE* of = fopen(filename,"wb");
+    if (of==NULL){
+        rebx_error(rebx, "REBOUNDx error: Can not open file passed to rebx_output_binary.");
+        return;
+    }
+    rebx_write_binary(rebx, of);
+    fclose(of);
+}
+
+void rebx_output_binary_to_buffer(struct rebx_extras* rebx, char** bufp, size_t* sizep){
+    *bufp = NULL;
+    *sizep = 0;
+    if (rebx->sim == NULL){
+        rebx_error(rebx, ""); // rebx_error gives meaningful err
+        return;
+    }
+#ifdef _WIN32
+    FILE* of = tmpfile(); // No memory streams on Windows, so go through a temporary file
+#else
+    FILE* of = open_memstream(bufp, sizep);
+#endif
+    if (of==NULL){
+        rebx_error(rebx, "REBOUNDx error: Can not open memory stream in rebx_output_binary_to_buffer.");
+        return;
+    }
+    rebx_write_binary(rebx, of);
+#ifdef _WIN32
+    const long size = ftell(of);
+    *bufp = malloc(size);
+    rewind(of);
+    if (*bufp == NULL || fread(*bufp, 1, size, of) != (size_t)size){
+        free(*bufp);
+        *bufp = NULL;
+        fclose(of);
+        rebx_error(rebx, "REBOUNDx error: Could not read back binary in rebx_output_binary_to_buffer.");
+        return;
+    }
+    *sizep = size;
+#endif
     fclose(of);
 }
+
+void rebx_output_free_buffer(char* buf){
+    free(buf);
+}
@@ -0,0 +1,152 @@
+/**
+ * @file    pool.c
+ * @brief   Internal slab allocator for small fixed-size REBOUNDx objects
+ * @author  Dan Tamayo <tamayo.daniel@gmail.com>
+ *
+ * @section     LICENSE
+ * Copyright (c) 2015 Dan Tamayo, Hanno Rein
+ *
+ * This file is part of reboundx.
+ *
+ * reboundx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * reboundx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with rebound.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include "pool.h"
+
+#define REBX_POOL_N_CLASSES 6
+#define REBX_POOL_SLOTS_PER_CHUNK 128
+
+static const size_t rebx_pool_slot_sizes[REBX_POOL_N_CLASSES] = {32, 48, 64, 96, 128, 256};
+
+// Chunks are carved into slots of one size class. Free slots are chained through their first word.
+struct rebx_pool_chunk{
+    struct rebx_pool_chunk* next;
+    double data[];              // double for alignment
+};
+
+// Objects too large for any slot size. Kept in a doubly linked list so they can be freed individually and in bulk.
+struct rebx_pool_large{
+    struct rebx_pool_large* prev;
+    struct rebx_pool_large* next;
+    double data[];
+};
+
+struct rebx_pool{
+    struct rebx_pool_chunk* chunks[REBX_POOL_N_CLASSES];
+    void* free_slots[REBX_POOL_N_CLASSES];
+    struct rebx_pool_large* large;
+};
+
+static int rebx_pool_class(const size_t size){
+    for (int c=0; c<REBX_POOL_N_CLASSES; c++){
+        if (size <= rebx_pool_slot_sizes[c]){
+            return c;
+        }
+    }
+    return -1;
+}
+
+struct rebx_pool* rebx_pool_create(void){
+    return calloc(1, sizeof(struct rebx_pool));
+}
+
+static int rebx_pool_add_chunk(struct rebx_pool* const pool, const int c){
+    const size_t slot_size = rebx_pool_slot_sizes[c];
+    struct rebx_pool_chunk* chunk = malloc(sizeof(*chunk) + REBX_POOL_SLOTS_PER_CHUNK*slot_size);
+    if (chunk == NULL){
+        return 0;
+    }
+    chunk->next = pool->chunks[c];
+    pool->chunks[c] = chunk;
+    char* slots = (char*)chunk->data;
+    for (int i=REBX_POOL_SLOTS_PER_CHUNK-1; i>=0; i--){  // so slots get handed out in address order
+        void* slot = slots + i*slot_size;
+        *(void**)slot = pool->free_slots[c];
+        pool->free_slots[c] = slot;
+    }
+    return 1;
+}
+
+void* rebx_pool_alloc(struct rebx_pool* const pool, const size_t size){
+    const int c = rebx_pool_class(size);
+    if (c < 0){
+        struct rebx_pool_large* large = calloc(1, sizeof(*large) + size);
+        if (large == NULL){
+            return NULL;
+        }
+        large->prev = NULL;
+        large->next = pool->large;
+        if (pool->large){
+            pool->large->prev = large;
+        }
+        pool->large = large;
+        return large->data;
+    }
+    if (pool->free_slots[c] == NULL){
+        if (!rebx_pool_add_chunk(pool, c)){
+            return NULL;
+        }
+    }
+    void* slot = pool->free_slots[c];
+    pool->free_slots[c] = *(void**)slot;
+    memset(slot, 0, rebx_pool_slot_sizes[c]);
+    return slot;
+}
+
+void rebx_pool_free(struct rebx_pool* const pool, void* const ptr, const size_t size){
+    if (ptr == NULL){
+        return;
+    }
+    const int c = rebx_pool_class(size);
+    if (c < 0){
+        struct rebx_pool_large* large = (struct rebx_pool_large*)((char*)ptr - offsetof(struct rebx_pool_large, data));
+        if (large->prev){
+            large->prev->next = large->next;
+        }
+        else{
+            pool->large = large->next;
+        }
+        if (large->next){
+            large->next->prev = large->prev;
+        }
+        free(large);
+        return;
+    }
+    *(void**)ptr = pool->free_slots[c];
+    pool->free_slots[c] = ptr;
+}
+
+void rebx_pool_destroy(struct rebx_pool* const pool){
+    if (pool == NULL){
+        return;
+    }
+    for (int c=0; c<REBX_POOL_N_CLASSES; c++){
+        struct rebx_pool_chunk* chunk = pool->chunks[c];
+        while (chunk != NULL){
+            struct rebx_pool_chunk* next = chunk->next;
+            free(chunk);
+            chunk = next;
+        }
+    }
+    struct rebx_pool_large* large = pool->large;
+    while (large != NULL){
+        struct rebx_pool_large* next = large->next;
+        free(large);
+        large = next;
+    }
+    free(pool);
+}
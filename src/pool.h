@@ -0,0 +1,50 @@
+/**
+ * @file    pool.h
+ * @brief   Internal slab allocator for small fixed-size REBOUNDx objects
+ * @author  Dan Tamayo <tamayo.daniel@gmail.com>
+ *
+ * @section     LICENSE
+ * Copyright (c) 2015 Dan Tamayo, Hanno Rein
+ *
+ * This file is part of reboundx.
+ *
+ * reboundx is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * reboundx is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with rebound.  If not, see <http://www.gnu.org/licenses/>.
+ *
+ */
+
+#ifndef _REBX_POOL_H
+#define _REBX_POOL_H
+
+#include <stddef.h>
+
+/**
+ * @brief Creates an empty pool. Memory is only requested from the system when the first object is allocated.
+ * @return Pointer to the new pool, or NULL if out of memory.
+ */
+struct rebx_pool* rebx_pool_create(void);
+/**
+ * @brief Returns zeroed memory of at least size bytes from the pool.
+ * @details Objects larger than the largest slot size get their own allocation, still tracked by the pool. The same size must be passed to rebx_pool_free.
+ */
+void* rebx_pool_alloc(struct rebx_pool* const pool, const size_t size);
+/**
+ * @brief Returns an object to the pool so its slot can be reused.
+ */
+void rebx_pool_free(struct rebx_pool* const pool, void* const ptr, const size_t size);
+/**
+ * @brief Frees all memory held by the pool in bulk, including objects that were never returned with rebx_pool_free, and the pool itself.
+ */
+void rebx_pool_destroy(struct rebx_pool* const pool);
+
+#endif
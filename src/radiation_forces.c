@@ -66,16 +66,18 @@
 #include <stdlib.h>
 #include "reboundx.h"
 
-static void rebx_calculate_radiation_forces(struct rebx_extras* const rebx, struct reb_simulation* const sim, const double c, const int source_index, struct reb_particle* const particles, const int N){
+static void rebx_calculate_radiation_forces(struct reb_simulation* const sim, const double c, const int source_index, struct reb_particle* const particles, const struct rebx_participants* const dust){
     const struct reb_particle source = particles[source_index];
     const double mu = sim->G*source.m;
 
-    for (int i=0;i<N;i++){
+    // No back-reaction on the source, so each iteration only writes its own particle
+#pragma omp parallel for if(dust->N >= REBX_OMP_MIN_N)
+    for (int j=0;j<dust->N;j++){    // only particles with beta set feel radiation forces
+        const int i = dust->indices[j];
         
         if(i == source_index) continue;
         
-        const double* beta = rebx_get_param(rebx, particles[i].ap, "beta");
-        if(beta == NULL) continue; // only particles with beta set feel radiation forces
+        const double* beta = dust->values[j];
         
         const struct reb_particle p = particles[i];
         const double dx = p.x - source.x; 
@@ -101,19 +103,22 @@ void rebx_radiation_forces(struct reb_simulation* const sim, struct rebx_force*
     struct rebx_extras* const rebx = sim->extras;
     double* c = rebx_get_param(rebx, radiation_forces->ap, "c");
     if (c == NULL){
-        reb_simulation_error(sim, "Need to set speed of light in radiation_forces effect.  See examples in documentation.\n");
+        rebx_error(sim->extras, "Need to set speed of light in radiation_forces effect.  See examples in documentation.\n");
         return;
     }
     
-    int source_found=0;
-    for (int i=0; i<N; i++){
-        if (rebx_get_param(rebx, particles[i].ap, "radiation_source") != NULL){
-            source_found = 1;
-            rebx_calculate_radiation_forces(rebx, sim, *c, i, particles, N);
-        }
+    const int source_key = rebx_get_param_key(rebx, "radiation_source");
+    const int beta_key = rebx_get_param_key(rebx, "beta");
+    const struct rebx_participants* const sources = rebx_get_participants(rebx, radiation_forces, particles, N, 1, &source_key);
+    const struct rebx_participants* const dust = rebx_get_participants(rebx, radiation_forces, particles, N, 1, &beta_key);
+    if (sources == NULL || dust == NULL){
+        return;
+    }
+    for (int j=0; j<sources->N; j++){
+        rebx_calculate_radiation_forces(sim, *c, sources->indices[j], particles, dust);
     }
-    if (!source_found){
-        rebx_calculate_radiation_forces(rebx, sim, *c, 0, particles, N);    // default source to index 0 if "radiation_source" not found on any particle
+    if (sources->N == 0){
+        rebx_calculate_radiation_forces(sim, *c, 0, particles, dust);    // default source to index 0 if "radiation_source" not found on any particle
     }
 }
 
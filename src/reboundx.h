@@ -57,7 +57,9 @@ enum rebx_param_type{
     REBX_TYPE_UINT32,
     REBX_TYPE_ORBIT,
     REBX_TYPE_ODE,
-    REBX_TYPE_VEC3D
+    REBX_TYPE_VEC3D,
+    REBX_TYPE_DOUBLE_ARRAY,     ///< Contiguous array of doubles. Length stored in rebx_param.length
+    REBX_TYPE_INT_ARRAY,        ///< Contiguous array of ints. Length stored in rebx_param.length
 };
 
 /**
@@ -95,6 +97,20 @@ enum rebx_operator_type{
     REBX_OPERATOR_RECORDER, ///< operator that leaves state unchanged. Just records
 };
 
+/**
+ * @brief Bit flags describing built-in effects. See rebx_get_effect_capabilities.
+ */
+enum rebx_effect_capability{
+    REBX_EFFECT_FORCE               = 1,    ///< Loaded with rebx_load_force
+    REBX_EFFECT_OPERATOR            = 2,    ///< Loaded with rebx_load_operator
+    REBX_EFFECT_VELOCITY_DEPENDENT  = 4,    ///< Force depends on velocities (REBX_FORCE_VEL)
+    REBX_EFFECT_RECORDER            = 8,    ///< Operator only records quantities (REBX_OPERATOR_RECORDER)
+    REBX_EFFECT_MODIFIES_PARAMS     = 16,   ///< Sets parameters while running, so it can't run concurrently with other effects
+    REBX_EFFECT_RANDOM              = 32,   ///< Draws random numbers from the simulation's generator
+    REBX_EFFECT_HAS_ENERGY          = 64,   ///< REBOUNDx provides a function for the associated energy or Hamiltonian
+    REBX_EFFECT_USES_GRAVITY        = 128,  ///< Force reuses the Newtonian accelerations REBOUND computed before the additional forces, when available
+};
+
 /**
  * @brief Different fields for binary files
  */
@@ -192,7 +208,54 @@ struct rebx_node{
 struct rebx_param{
     char* name;                 ///< For searching linked lists and informative errors
     enum rebx_param_type type;  ///< Needed to cast value
+    int pooled;                 ///< 1 if the param (with its list node and inline value) was allocated from the extras' parameter pool, 0 if it was malloc'd
     void* value;                ///< Pointer to parameter value
+    int key;                    ///< Interned key of the registered parameter name (-1 if not registered). See rebx_get_param_key.
+    int length;                 ///< Number of elements for REBX_TYPE_DOUBLE_ARRAY and REBX_TYPE_INT_ARRAY params (0 for other types)
+};
+
+/**
+ * @brief Binding of a REBX_TYPE_DOUBLE parameter to the interpolator that sets its value. See rebx_set_param_interpolator.
+ */
+
+struct rebx_interpolated_param{
+    struct rebx_param* param;                   ///< Bound parameter
+    struct rebx_interpolator* interpolator;     ///< Evaluated at the current simulation time before effects run. Owned by REBOUNDx.
+};
+
+#define REBX_PARTICIPANTS_MAX_KEYS 16   ///< Maximum number of parameter keys resolved by a compiled participant list
+#define REBX_OMP_MIN_N 64               ///< Built-in force kernels only spawn OpenMP threads for at least this many particles
+#define REBX_DETERMINISTIC_BLOCK_SIZE 64    ///< Loop iterations per block of rebx_acc_buffers with rebx_extras.deterministic_reductions
+
+/**
+ * @brief Compiled list of the particles that participate in a force.
+ * @details Built by rebx_get_participants and cached on the force. Holds the indices of all particles carrying at least one of the requested parameters, together with the resolved value pointers, so forces can loop over a dense array instead of walking every particle's parameter list. Rebuilt automatically when the parameter generation counter (see rebx_extras) changes or particles are added, removed or reordered.
+ */
+struct rebx_participants{
+    int N;                          ///< Number of participating particles
+    int* indices;                   ///< Indices of the participating particles in the particles array
+    void** values;                  ///< Resolved value pointers, N_keys per participant (NULL where a parameter is not set)
+    struct rebx_node** aps;         ///< Particle parameter lists at build time. Used to detect particles that moved in the array
+    int N_allocated;                ///< Allocated length of indices and aps
+    int N_keys;                     ///< Number of parameter keys
+    int keys[REBX_PARTICIPANTS_MAX_KEYS];   ///< Parameter keys resolved for each participant
+    unsigned long generation;       ///< Parameter generation counter when the list was built
+    int N_particles;                ///< Number of particles in the array when the list was built
+    struct rebx_participants* next; ///< Next compiled list cached on the same force
+};
+
+/**
+ * @brief Acceleration buffers for parallel force kernels.
+ * @details The kernel's loop range [0, N) is split into N_blocks contiguous blocks, and each block accumulates back-reactions into its own 3*N_slots doubles. See rebx_get_acc_buffers.
+ */
+struct rebx_acc_buffers{
+    double* acc;            ///< N_blocks blocks of stride doubles
+    int N_slots;            ///< Number of particles receiving back-reactions
+    int stride;             ///< 3*N_slots rounded up to a cache line, so blocks don't share lines
+    int N;                  ///< Number of loop iterations partitioned into blocks
+    int N_blocks;           ///< Number of blocks
+    int block_size;         ///< Loop iterations per block (the last one can be shorter)
+    size_t N_allocated;     ///< Allocated length of acc
 };
 
 /**
@@ -205,6 +268,10 @@ struct rebx_force{
     // See comments in params.py in __init__
     enum rebx_force_type force_type;    ///< Force type for internal logic
     void (*update_accelerations) (struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N); ///< Function pointer to add additional accelerations
+    struct rebx_participants* participants; ///< Compiled participant lists (see rebx_get_participants)
+    struct rebx_acc_buffers* acc_buffers;   ///< Acceleration buffers for parallel kernels (see rebx_get_acc_buffers)
+    void* workspace;            ///< Scratch memory kept between calls (see rebx_get_workspace)
+    size_t workspace_size;      ///< Allocated size of workspace in bytes
 };
 
 /**
@@ -243,6 +310,7 @@ struct rebx_interpolator{
     int Nvalues;
     double* y2;
     int klo;
+    int* refcount;                                  ///< Number of interpolators sharing the times, values and y2 tables.
 };
 /**
  * @brief Main REBOUNDx structure.
@@ -255,9 +323,24 @@ struct rebx_extras {
     struct rebx_node* pre_timestep_modifications;   ///< Linked list of rebx_steps to apply before each timestep
 	struct rebx_node* post_timestep_modifications;  ///< Linked list of rebx_steps to apply after each timestep
 
-    struct rebx_node* registered_params;            ///< Linked list of rebx_params with all the parameter names registered with their type (for type safety)
+    struct rebx_node* registered_params;            ///< Linked list of user registered rebx_params with their type (for type safety). Default params live in a static table
     struct rebx_node* allocated_forces;             ///< For memory management
     struct rebx_node* allocated_operators;          ///< For memory management
+
+    struct rebx_param** param_keys;                 ///< User registered params, indexed by their interned key minus the number of default params
+    int N_param_keys;                               ///< Number of interned keys (default and user registered params)
+    int N_allocated_param_keys;                     ///< Allocated length of param_keys
+    unsigned long param_generation;                 ///< Incremented whenever parameters are added to or removed from any object. Invalidates compiled participant lists
+    struct rebx_pool* pool;                         ///< Slab allocator holding all parameters attached to particles, forces and operators. Freed in bulk by rebx_free
+    int* param_index;                               ///< Open addressing hash index from user registered param names to keys
+    int N_allocated_param_index;                    ///< Number of slots in param_index (power of 2)
+    struct rebx_plan* plan;                         ///< Flattened forces and operator steps executed each timestep. Rebuilt when effects are added or removed
+    struct rebx_interpolated_param* interpolated_params; ///< Params bound to an interpolator, refreshed once per simulation time before effects run
+    int N_interpolated_params;                      ///< Number of params in interpolated_params
+    int N_allocated_interpolated_params;            ///< Allocated length of interpolated_params
+    double interpolated_params_t;                   ///< Simulation time at which interpolated_params were last refreshed (NaN to force a refresh)
+    int parallel_forces;                            ///< If 1, built-in forces that only write accelerations are evaluated concurrently as OpenMP tasks, each on a private copy of the particles, and merged in the order they were added (errors and warnings they raise are reported at the same point). Off by default.
+    int deterministic_reductions;                   ///< If 1, parallel force kernels partition their loops into blocks of fixed size (REBX_DETERMINISTIC_BLOCK_SIZE) and sum the blocks in a fixed order, so results are bitwise identical for any number of threads. Off by default.
 };
 
 /****************************************
@@ -280,6 +363,15 @@ struct rebx_extras {
  */
 struct rebx_extras* rebx_attach(struct reb_simulation* sim);
 
+/**
+ * @brief Attaches a copy of a REBOUNDx instance to another simulation.
+ * @details Deep copies all forces, operators and their steps, along with all effect and particle parameters. Force parameters point to the copied forces, and parameters bound to interpolators share the source's interpolation tables. sim_dst is typically a copy of rebx_src->sim made with reb_simulation_copy, and must have the same number of particles.
+ * @param sim_dst Pointer to the reb_simulation to which to attach the copy.
+ * @param rebx_src Pointer to the rebx_extras instance to copy.
+ * @return Pointer to the new rebx_extras structure, or NULL if the copy failed.
+ */
+struct rebx_extras* rebx_copy(struct reb_simulation* sim_dst, struct rebx_extras* rebx_src);
+
 /**
  * @brief Detaches REBOUNDx from simulation, resetting all the simulation's function pointers that REBOUNDx has set.
  * @details This does not free the memory allocated by REBOUNDx (call rebx_free).
@@ -318,6 +410,37 @@ struct rebx_extras* rebx_create_extras_from_binary(struct reb_simulation* sim, c
  * @param warnings Pointer to an array of warnings to be populated during loading.
  */
 void rebx_init_extras_from_binary(struct rebx_extras* rebx, const char* const filename, enum rebx_input_binary_messages* warnings);
+
+/**
+ * @brief Same as rebx_output_binary(), but writes the binary to a newly allocated block of memory instead of a file.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param bufp Pointer to a char pointer that is set to the buffer. The caller is responsible for freeing it with free().
+ * @param sizep Pointer to a size_t that is set to the size of the buffer in bytes.
+ */
+void rebx_output_binary_to_buffer(struct rebx_extras* rebx, char** bufp, size_t* sizep);
+
+/**
+ * @brief Frees a buffer returned by rebx_output_binary_to_buffer(). Equivalent to free(), for callers such as Python that cannot call free() from the same C library.
+ * @param buf Pointer to the buffer.
+ */
+void rebx_output_free_buffer(char* buf);
+
+/**
+ * @brief Same as rebx_create_extras_from_binary(), but reads the binary from a block of memory written by rebx_output_binary_to_buffer().
+ * @param sim Pointer to the simulation to which the effects and parameters should be added.
+ * @param buf Pointer to the buffer.
+ * @param size Size of the buffer in bytes.
+ */
+struct rebx_extras* rebx_create_extras_from_buffer(struct reb_simulation* sim, const char* const buf, const size_t size);
+
+/**
+ * @brief Same as rebx_init_extras_from_binary(), but reads the binary from a block of memory written by rebx_output_binary_to_buffer().
+ * @param rebx Pointer to a rebx_extras instance to be updated.
+ * @param buf Pointer to the buffer.
+ * @param size Size of the buffer in bytes.
+ * @param warnings Pointer to an array of warnings to be populated during loading.
+ */
+void rebx_init_extras_from_buffer(struct rebx_extras* rebx, const char* const buf, const size_t size, enum rebx_input_binary_messages* warnings);
 /** @} */
 /** @} */
 
@@ -346,6 +469,13 @@ int rebx_add_operator_step(struct rebx_extras* rebx, struct rebx_operator* opera
 int rebx_add_force(struct rebx_extras* rebx, struct rebx_force* force);
 struct rebx_operator* rebx_load_operator(struct rebx_extras* const rebx, const char* name);
 struct rebx_force* rebx_load_force(struct rebx_extras* const rebx, const char* name);
+
+/**
+ * @brief Reports what a built-in effect does.
+ * @param name Name of the force or operator, as passed to rebx_load_force or rebx_load_operator.
+ * @return Bitwise or of rebx_effect_capability flags, or 0 if there is no built-in effect with that name.
+ */
+unsigned int rebx_get_effect_capabilities(const char* name);
 struct rebx_operator* rebx_create_operator(struct rebx_extras* const rebx, const char* name);
 struct rebx_force* rebx_create_force(struct rebx_extras* const rebx, const char* name);
 /**
@@ -422,7 +552,133 @@ void rebx_set_param_double(struct rebx_extras* const rebx, struct rebx_node** ap
 void rebx_set_param_int(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, int val);
 void rebx_set_param_uint32(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, uint32_t val);
 void rebx_set_param_vec3d(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, struct reb_vec3d val);
-void rebx_register_param(struct rebx_extras* const rebx, const char* name, enum rebx_param_type type);
+
+/**
+ * @brief Sets a REBX_TYPE_DOUBLE parameter on many particles at once from a contiguous array.
+ * @details Looks up the parameter name once, so this is much faster than calling rebx_set_param_double in a loop over particles (or from Python).
+ * @param rebx Pointer to the rebx_extras instance
+ * @param param_name Name of the parameter to set
+ * @param start If indices is NULL, values are set on particles start to start+N-1. Ignored otherwise.
+ * @param indices Array of N particle indices to set the parameter on, or NULL for a contiguous range.
+ * @param N Number of particles to set
+ * @param values Array of N values. values[i] goes to the i-th particle of the range or index list.
+ * @return 1 on success, 0 on failure (e.g., unregistered name, wrong type or index out of range).
+ */
+int rebx_set_particles_param_double(struct rebx_extras* const rebx, const char* const param_name, const int start, const int* const indices, const int N, const double* const values);
+
+/**
+ * @brief Gathers a REBX_TYPE_DOUBLE parameter from many particles into a contiguous array.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param param_name Name of the parameter to get
+ * @param start If indices is NULL, values are read from particles start to start+N-1. Ignored otherwise.
+ * @param indices Array of N particle indices to read the parameter from, or NULL for a contiguous range.
+ * @param N Number of particles to read
+ * @param values Array of length N to fill. Set to NaN for particles that don't have the parameter.
+ * @return Number of particles that had the parameter set, or -1 on failure.
+ */
+int rebx_get_particles_param_double(struct rebx_extras* const rebx, const char* const param_name, const int start, const int* const indices, const int N, double* const values);
+
+/**
+ * @brief Sets a REBX_TYPE_DOUBLE_ARRAY parameter, copying N values into storage owned by REBOUNDx.
+ * @details rebx_get_param returns a pointer to the first element, and rebx_get_param_length the number of elements. Setting it again replaces the array (and invalidates previously returned pointers).
+ * @param rebx Pointer to the rebx_extras instance
+ * @param apptr Pointer to the ap field of the particle, force or operator
+ * @param param_name Name of the parameter
+ * @param values Array of N values to copy
+ * @param N Number of elements
+ */
+void rebx_set_param_array_double(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, const double* const values, const int N);
+/**
+ * @brief Same as rebx_set_param_array_double, for REBX_TYPE_INT_ARRAY parameters.
+ */
+void rebx_set_param_array_int(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, const int* const values, const int N);
+/**
+ * @brief Gets the number of elements of an array parameter.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param ap Pointer from which to get the param
+ * @param param_name Name of the parameter
+ * @return Number of elements for array types, 1 for other types, and 0 if the parameter is not found.
+ */
+int rebx_get_param_length(struct rebx_extras* const rebx, struct rebx_node* ap, const char* const param_name);
+
+/**
+ * @brief Registers a new parameter name with its type.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param name Name of the new parameter
+ * @param type Type of the new parameter
+ * @return Interned key for the parameter name (see rebx_get_param_by_key), or -1 if registration failed.
+ */
+int rebx_register_param(struct rebx_extras* const rebx, const char* name, enum rebx_param_type type);
+
+/**
+ * @brief Gets the interned key for a registered parameter name.
+ * @details Looking up parameters by key avoids string comparisons, so effects should look up the keys they need once (e.g. at the top of their update function) and use the _by_key functions inside loops over particles.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param param_name Name of the registered parameter
+ * @return Key for the parameter, or -1 if the name has not been registered.
+ */
+int rebx_get_param_key(struct rebx_extras* const rebx, const char* const param_name);
+
+/**
+ * @brief Same as rebx_get_param, but takes the interned key returned by rebx_get_param_key.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param ap Pointer from which to get the param
+ * @param key Interned key of the parameter
+ * @return A void pointer to the parameter. NULL if not found.
+ */
+void* rebx_get_param_by_key(struct rebx_extras* const rebx, struct rebx_node* ap, const int key);
+struct rebx_param* rebx_get_param_struct_by_key(struct rebx_extras* const rebx, struct rebx_node* ap, const int key);
+void rebx_set_param_pointer_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, void* val);
+void rebx_set_param_double_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, double val);
+void rebx_set_param_int_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, int val);
+void rebx_set_param_uint32_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, uint32_t val);
+void rebx_set_param_vec3d_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, struct reb_vec3d val);
+void rebx_set_param_array_double_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, const double* const values, const int N);
+void rebx_set_param_array_int_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key, const int* const values, const int N);
+
+/**
+ * @brief Returns the compiled list of particles carrying at least one of the passed parameter keys.
+ * @details The list is cached on the force and only rebuilt when parameters are added or removed, or when particles are added, removed or reordered, so calling this at the top of every update_accelerations is cheap. The value pointer for key k of participant j is values[j*N_keys + k].
+ * @param rebx Pointer to the rebx_extras instance
+ * @param force Force on which to cache the list
+ * @param particles Particles array passed to the force
+ * @param N Number of particles in the array
+ * @param N_keys Number of keys (at most REBX_PARTICIPANTS_MAX_KEYS)
+ * @param keys Parameter keys (see rebx_get_param_key)
+ * @return Pointer to the compiled list. NULL on error.
+ */
+const struct rebx_participants* rebx_get_participants(struct rebx_extras* const rebx, struct rebx_force* const force, struct reb_particle* const particles, const int N, const int N_keys, const int* const keys);
+
+/**
+ * @brief Returns zeroed acceleration buffers for a parallel force kernel.
+ * @details Parallel kernels loop over blocks (see rebx_block_acc), write the acceleration of the particle owned by each loop iteration directly, and accumulate back-reactions on other particles (e.g. a central body) into their block's buffer. rebx_reduce_acc_buffers then adds the blocks' contributions to the particles. By default there is one block per thread. With rebx_extras.deterministic_reductions the blocks have a fixed size, so the partition and the order of the sum don't depend on the number of threads. The buffers are cached on the force and only reallocated when they need to grow.
+ * @param rebx Pointer to the rebx_extras instance
+ * @param force Force on which to cache the buffers
+ * @param N_slots Number of particles receiving back-reactions. Each block gets 3*N_slots doubles (x, y, z for each slot).
+ * @param N Number of loop iterations to partition into blocks
+ * @return Pointer to the buffers. NULL on error.
+ */
+struct rebx_acc_buffers* rebx_get_acc_buffers(struct rebx_extras* const rebx, struct rebx_force* const force, const int N_slots, const int N);
+/**
+ * @brief Returns the buffer of a block and sets its loop range [start, end).
+ */
+double* rebx_block_acc(struct rebx_acc_buffers* const buffers, const int block, int* const start, int* const end);
+/**
+ * @brief Sums the blocks pairwise in a fixed order and adds the result to the particles.
+ * @param buffers Buffers returned by rebx_get_acc_buffers
+ * @param particles Particles array passed to the force
+ * @param indices Particle index for each slot. Pass NULL if slot i corresponds to particles[i].
+ */
+void rebx_reduce_acc_buffers(struct rebx_acc_buffers* const buffers, struct reb_particle* const particles, const int* const indices);
+/**
+ * @brief Returns scratch memory of at least size bytes that is kept on the force between calls.
+ * @details The memory is only reallocated when a larger size is requested (e.g. when particles are added), and is freed with the force. Its contents are not preserved across reallocations.
+ * @param rebx Pointer to the extras instance
+ * @param force Force the workspace belongs to
+ * @param size Size in bytes
+ * @return Pointer to the workspace. NULL on error.
+ */
+void* rebx_get_workspace(struct rebx_extras* const rebx, struct rebx_force* const force, const size_t size);
 
 /** @} */
 /** @} */
@@ -619,6 +875,7 @@ struct rebx_tides_dynamical_mode rebx_calculate_tides_dynamical_mode_evolution(d
  */
 void* rebx_get_param_check(struct reb_simulation* sim, struct rebx_node* ap, const char* const param_name, enum rebx_param_type param_type);
 struct rebx_param* rebx_get_or_add_param(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name);
+struct rebx_param* rebx_get_or_add_param_by_key(struct rebx_extras* const rebx, struct rebx_node** apptr, const int key);
 
 
 /****************************************
@@ -720,6 +977,127 @@ void rebx_free_interpolator(struct rebx_interpolator* const interpolator);
  * @return Interpolated value at passed time.
  */
 double rebx_interpolate(struct rebx_extras* const rebx, struct rebx_interpolator* const interpolator, const double time);
+
+/**
+ * @brief Binds a REBX_TYPE_DOUBLE parameter to an interpolator, so its value follows the interpolated values in time.
+ * @details REBOUNDx refreshes the parameter at most once per distinct simulation time, before forces and operators run, so effects keep reading a plain double. This replaces setting the parameter manually with rebx_interpolate every timestep. REBOUNDx stores its own copy of the interpolator, so the passed one can be freed afterwards. Setting the parameter with rebx_set_param_double removes the binding. The binding is not saved to binaries (only the current value is).
+ * @param rebx Pointer to the REBOUNDx extras instance.
+ * @param apptr Pointer to the ap field of the particle or effect the parameter belongs to. The parameter is added if it does not exist.
+ * @param param_name Name of the parameter (must be registered as REBX_TYPE_DOUBLE).
+ * @param interpolator Interpolator to bind. Pass NULL to remove an existing binding (the parameter keeps its last value).
+ * @return 1 on success, 0 otherwise.
+ */
+int rebx_set_param_interpolator(struct rebx_extras* const rebx, struct rebx_node** apptr, const char* const param_name, const struct rebx_interpolator* const interpolator);
+/** @} */
+/** @} */
+
+/****************************************
+ Ensemble Routines
+ *****************************************/
+/**
+ * \name Ensemble Routines
+ * @{
+ */
+/**
+ * @defgroup EnsembleFunctions
+ * @details Functions for integrating many independent copies of a simulation that share one REBOUNDx configuration.
+ * @{
+ */
+
+/**
+ * @brief One column of an ensemble's parameter override table.
+ * @details Sets a REBX_TYPE_DOUBLE parameter to a different value on each member before it is integrated.
+ */
+struct rebx_ensemble_param{
+    const char* name;               ///< Name of the (registered) parameter
+    const char* effect;             ///< Name of the force or operator the parameter belongs to, or NULL for a particle parameter
+    int index;                      ///< Index of the particle the parameter belongs to (ignored if effect is set)
+    const double* values;           ///< One value per member
+};
+
+/**
+ * @brief Configuration and results of an ensemble run. See rebx_integrate_ensemble.
+ * @details All arrays are allocated by the caller. Set unused fields to 0 / NULL.
+ */
+struct rebx_ensemble{
+    int N_members;                  ///< Number of members
+    double tmax;                    ///< Time to which each member is integrated
+    int N_params;                   ///< Number of columns in params
+    const struct rebx_ensemble_param* params;   ///< Parameter override table
+    void (*setup)(struct reb_simulation* const sim, struct rebx_extras* const rebx, const int member, void* ref);    ///< Optional. Called on each member after the overrides are applied and before it is integrated, e.g. to change initial conditions
+    void (*record)(struct reb_simulation* const sim, struct rebx_extras* const rebx, const int member, double* const results, void* ref);    ///< Optional. Fills the member's N_results values after it is integrated. If NULL, the final x, y, z, vx, vy, vz of each particle are recorded (N_results must be 6*N)
+    int N_results;                  ///< Number of values recorded per member
+    double* results;                ///< N_members*N_results values, one row per member. Rows of members that could not be set up are filled with NaN
+    enum REB_STATUS* status;        ///< Optional, N_members entries. Receives the status each member's integration ended with
+    int N_threads;                  ///< Number of threads (0 for the OpenMP default). Ignored when compiled without OpenMP
+    void* ref;                      ///< Passed to setup and record
+};
+
+/**
+ * @brief Integrates an ensemble of independent copies of rebx's simulation in parallel.
+ * @details Each member is a deep copy of the template simulation and its REBOUNDx effects and parameters, with the override table applied. Members are handed to threads one at a time as they finish, so members that take very different times to integrate are balanced across threads. The template is not modified. When compiled with OpenMP, force kernels inside a member run single-threaded.
+ * @param rebx Pointer to the REBOUNDx extras instance attached to the template simulation.
+ * @param ensemble Pointer to the ensemble configuration, which also receives the results.
+ * @return 1 on success, 0 if the configuration is invalid (nothing is integrated).
+ */
+int rebx_integrate_ensemble(struct rebx_extras* const rebx, struct rebx_ensemble* const ensemble);
+
+/**
+ * @brief Header at the start of a result file written by rebx_integrate_ensemble_processes.
+ * @details The header is followed by the REBOUNDx binary the members were configured from, and then by N_members records of record_size bytes, starting at offset_records. Use rebx_ensemble_file_member to find a member's record in a mapped file.
+ */
+struct rebx_ensemble_file_header{
+    char signature[32];             ///< "REBOUNDx Ensemble File"
+    int N_members;                  ///< Number of members
+    int N;                          ///< Number of particles in each member
+    int N_workers;                  ///< Number of worker processes
+    double tmax;                    ///< Time to which each member is integrated
+    long offset_binary;             ///< Offset of the REBOUNDx binary from the start of the file
+    long binary_size;               ///< Size of the REBOUNDx binary in bytes
+    long offset_records;            ///< Offset of the first member record from the start of the file
+    long record_size;               ///< Size of one member record in bytes
+    long next_member;               ///< Next member to be claimed by a worker (updated atomically)
+    long N_completed;               ///< Number of members that have finished (updated atomically)
+};
+
+/**
+ * @brief Final state of one particle in a member record.
+ */
+struct rebx_ensemble_particle_record{
+    double x, y, z, vx, vy, vz;     ///< Final position and velocity
+    double a, e, inc, Omega, omega, f;  ///< Final orbit about particles[0] (NaN for particles[0] and unbound orbits)
+    double min_distance;            ///< Final min_distance parameter (NaN if not set)
+    struct reb_vec3d spin;          ///< Final Omega (spin) parameter (NaN if not set)
+};
+
+/**
+ * @brief Fixed-size record of one member in a result file.
+ */
+struct rebx_ensemble_member_record{
+    int status;                     ///< REB_STATUS the integration ended with, or REB_STATUS_RUNNING while the member has not finished
+    int worker;                     ///< Index of the worker process that integrated the member (-1 if unclaimed)
+    double t;                       ///< Final simulation time
+    double energy_error;            ///< Relative change in reb_simulation_energy over the integration
+    struct rebx_ensemble_particle_record particles[];  ///< N particle records
+};
+
+/**
+ * @brief Integrates an ensemble in worker processes that write their results to a shared memory-mapped file.
+ * @details For ensembles too large for one process. The result file is created (or overwritten), the REBOUNDx configuration is stored in it as a binary, and N_workers processes are forked. Workers claim members through an atomic counter in the file header, set each member up from a copy of the template simulation and the stored binary, apply the override table and setup, integrate it and write its record directly into the mapped file. Like binaries, custom forces and operators are not supported. When compiled with OpenMP, workers run force kernels (and REBOUND's) single-threaded, since the runtime's threads do not survive fork. The record, results, N_results and N_threads fields of ensemble are not used, and status (if set) receives the members' final status. Only available on POSIX systems.
+ * @param rebx Pointer to the REBOUNDx extras instance attached to the template simulation.
+ * @param ensemble Pointer to the ensemble configuration.
+ * @param filename Name of the result file.
+ * @param N_workers Number of worker processes (0 for the number of online processors).
+ * @return 1 on success, 0 if the configuration is invalid or the file or workers could not be created.
+ */
+int rebx_integrate_ensemble_processes(struct rebx_extras* const rebx, struct rebx_ensemble* const ensemble, const char* const filename, int N_workers);
+
+/**
+ * @brief Returns a pointer to a member's record in a mapped result file written by rebx_integrate_ensemble_processes.
+ * @param header Pointer to the start of the mapped file.
+ * @param member Index of the member.
+ */
+struct rebx_ensemble_member_record* rebx_ensemble_file_member(struct rebx_ensemble_file_header* const header, const int member);
 /** @} */
 /** @} */
 
@@ -762,4 +1140,5 @@ void rebx_input_skip_binary_field(FILE* inf, long field_size);
 /** @} */
 
 void rebx_error(struct rebx_extras* rebx, const char* const msg);
+void rebx_warning(struct rebx_extras* rebx, const char* const msg);
 #endif
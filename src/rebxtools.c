@@ -63,7 +63,8 @@ double rebx_Edot(struct reb_particle* const ps, const int N){
     return Edot;
 }
 
-void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const force, const enum REBX_COORDINATES coordinates, const int back_reactions_inclusive, const char* reference_name, struct reb_vec3d (*calculate_force) (struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source), struct reb_particle* const particles, const int N){
+/* keys is passed through unchanged to calculate_force, so effects can resolve their parameter keys once per call. */
+void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const force, const enum REBX_COORDINATES coordinates, const int back_reactions_inclusive, const char* reference_name, struct reb_vec3d (*calculate_force) (struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source, const void* const keys), const void* const keys, struct reb_particle* const particles, const int N){
     struct rebx_extras* const rebx = sim->extras;
     struct reb_particle com = reb_simulation_com(sim); // Start with full com for jacobi and barycentric coordinates.
 
@@ -72,9 +73,10 @@ void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const f
         refindex = 0;                           // There is no jacobi coordinate for the 0th particle, so set refindex to skip it in loop below.
     }
     else if(coordinates == REBX_COORDINATES_PARTICLE){
+        const int reference_key = rebx_get_param_key(rebx, reference_name);
         for (int i=0; i < N; i++){
 			struct reb_particle* p = &particles[i];
-            const int* const reference = rebx_get_param(rebx, p->ap, reference_name);
+            const int* const reference = rebx_get_param_by_key(rebx, p->ap, reference_key);
             if (reference){
                 com = particles[i];
                 refindex = i;
@@ -83,12 +85,13 @@ void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const f
             if (i == N-1){
                 char str[200];
                 sprintf(str, "Coordinates set to REBX_COORDINATES_PARTICLE, but %s param was not found in any particle.  Need to set parameter.\n", reference_name);
-                reb_simulation_error(sim, str);
+                rebx_error(sim->extras, str);
             }
         }
     }
 
 
+    struct reb_vec3d back_reaction = {0};     // Running sum of massratio*a over the particles processed so far, so back-reactions cost O(N) rather than O(N^2)
     for(int i=N-1; i>=0; i--){ // Run through backwards so each iteration does not depend on previous ones in Jacobi coordinates.
         if (i==refindex){
             continue;
@@ -98,7 +101,7 @@ void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const f
             com = rebx_get_com_without_particle(com, *p);
         }
 
-        struct reb_vec3d a = calculate_force(sim, force, p, &com);
+        struct reb_vec3d a = calculate_force(sim, force, p, &com, keys);
         p->ax += a.x;
         p->ay += a.y;
         p->az += a.z;
@@ -107,23 +110,29 @@ void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const f
         switch(coordinates){
             case REBX_COORDINATES_BARYCENTRIC:
                 massratio = p->m/com.m;
-                for(int j=0; j < N; j++){
-                    particles[j].ax -= massratio*a.x;
-                    particles[j].ay -= massratio*a.y;
-                    particles[j].az -= massratio*a.z;
-                }
+                back_reaction.x += massratio*a.x;   // felt by all particles, applied after the loop
+                back_reaction.y += massratio*a.y;
+                back_reaction.z += massratio*a.z;
                 break;
             case REBX_COORDINATES_JACOBI:
+                // Felt by particles j < i (j <= i if inclusive). Going backwards, back_reaction already holds the contributions of all particles above i
                 if(back_reactions_inclusive){
                     massratio = p->m/(com.m + p->m);
+                    back_reaction.x += massratio*a.x;
+                    back_reaction.y += massratio*a.y;
+                    back_reaction.z += massratio*a.z;
+                    p->ax -= back_reaction.x;
+                    p->ay -= back_reaction.y;
+                    p->az -= back_reaction.z;
                 }
                 else{
                     massratio = p->m/com.m;
-                }
-                for(int j=0; j < i + back_reactions_inclusive; j++){    // stop at j=i if inclusive, at i-1 if not
-                    particles[j].ax -= massratio*a.x;
-                    particles[j].ay -= massratio*a.y;
-                    particles[j].az -= massratio*a.z;
+                    p->ax -= back_reaction.x;
+                    p->ay -= back_reaction.y;
+                    p->az -= back_reaction.z;
+                    back_reaction.x += massratio*a.x;
+                    back_reaction.y += massratio*a.y;
+                    back_reaction.z += massratio*a.z;
                 }
                 break;
             case REBX_COORDINATES_PARTICLE:
@@ -141,9 +150,21 @@ void rebx_com_force(struct reb_simulation* const sim, struct rebx_force* const f
                 particles[refindex].az -= massratio*a.z;
                 break;
             default:
-                reb_simulation_error(sim, "Coordinates not supported in REBOUNDx.\n");
+                rebx_error(sim->extras, "Coordinates not supported in REBOUNDx.\n");
+        }
+    }
+    if (coordinates == REBX_COORDINATES_BARYCENTRIC){
+        for(int j=0; j < N; j++){
+            particles[j].ax -= back_reaction.x;
+            particles[j].ay -= back_reaction.y;
+            particles[j].az -= back_reaction.z;
         }
     }
+    else if (coordinates == REBX_COORDINATES_JACOBI){
+        particles[0].ax -= back_reaction.x;    // skipped in the loop
+        particles[0].ay -= back_reaction.y;
+        particles[0].az -= back_reaction.z;
+    }
 }
 
 static inline void rebx_subtract_posvel(struct reb_particle* p, struct reb_particle* diff, const double massratio){
@@ -158,9 +179,10 @@ static inline void rebx_subtract_posvel(struct reb_particle* p, struct reb_parti
 /* only accepts one reference particle if coordinates=REBX_COORDINATES_PARTICLE.
  * calculate_effect function should check for edge case where particle and reference are the same
  * (could happen e.g. with barycentric coordinates with test particles and single massive body)
+ * keys is passed through unchanged to calculate_step, so effects can resolve their parameter keys once per call.
  */
 
-void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator* const operator, const enum REBX_COORDINATES coordinates, const int back_reactions_inclusive, const char* reference_name, struct reb_particle (*calculate_step) (struct reb_simulation* const sim, struct rebx_operator* const operator, struct reb_particle* p, struct reb_particle* source, const double dt), const double dt){
+void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator* const operator, const enum REBX_COORDINATES coordinates, const int back_reactions_inclusive, const char* reference_name, struct reb_particle (*calculate_step) (struct reb_simulation* const sim, struct rebx_operator* const operator, struct reb_particle* p, struct reb_particle* source, const double dt, const void* const keys), const void* const keys, const double dt){
     struct rebx_extras* const rebx = sim->extras;
     const int N_real = sim->N - sim->N_var;
     struct reb_particle com = reb_simulation_com(sim); // Start with full com for jacobi and barycentric coordinates.
@@ -170,9 +192,10 @@ void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator*
         refindex = 0;                           // There is no jacobi coordinate for the 0th particle, so should skip index 0
     }
     else if(coordinates == REBX_COORDINATES_PARTICLE){
+        const int reference_key = rebx_get_param_key(rebx, reference_name);
         for (int i=0; i < N_real; i++){
             struct reb_particle* p = &sim->particles[i];
-            const int* const reference = rebx_get_param(rebx, p->ap, reference_name);
+            const int* const reference = rebx_get_param_by_key(rebx, p->ap, reference_key);
             if (reference){
                 com = sim->particles[i];
                 refindex = i;
@@ -181,22 +204,26 @@ void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator*
             if (i == N_real-1){
                 char str[200];
                 sprintf(str, "Coordinates set to REBX_COORDINATES_PARTICLE, but %s param was not found in any particle.  Need to set parameter.\n", reference_name);
-                reb_simulation_error(sim, str);
+                rebx_error(sim->extras, str);
             }
         }
     }
 
 
+    struct reb_particle shift = {0};    // Running sum of massratio*diff over the particles processed so far, so back-reactions cost O(N) rather than O(N^2)
     for(int i=N_real-1; i>=0; i--){ // Run through backwards so each iteration does not depend on previous ones in Jacobi coordinates.
         if (i==refindex){
             continue;
         }
         struct reb_particle* p = &sim->particles[i];
+        if (coordinates == REBX_COORDINATES_BARYCENTRIC || coordinates == REBX_COORDINATES_JACOBI){
+            rebx_subtract_posvel(p, &shift, 1.);    // back-reactions from the particles above i, which it would have felt before its own step
+        }
         if (coordinates == REBX_COORDINATES_JACOBI){
             com = rebx_get_com_without_particle(com, *p);
         }
 
-        struct reb_particle modified_particle = calculate_step(sim, operator, p, &com, dt);
+        struct reb_particle modified_particle = calculate_step(sim, operator, p, &com, dt, keys);
         struct reb_particle diff = rebx_particle_minus(modified_particle, *p);
         p->x = modified_particle.x;
         p->y = modified_particle.y;
@@ -209,20 +236,19 @@ void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator*
         switch(coordinates){
             case REBX_COORDINATES_BARYCENTRIC:
                 massratio = p->m/com.m;
-                for(int j=0; j < N_real; j++){
-                    rebx_subtract_posvel(&sim->particles[j], &diff, massratio);
-                }
+                rebx_subtract_posvel(p, &shift, -1.);   // the full sum is subtracted from all particles after the loop
+                rebx_subtract_posvel(&shift, &diff, -massratio);
                 break;
             case REBX_COORDINATES_JACOBI:
+                // Felt by particles j < i (j <= i if inclusive). Particles below i pick up shift before their own step
                 if(back_reactions_inclusive){
                     massratio = p->m/(com.m + p->m);
+                    rebx_subtract_posvel(p, &diff, massratio);
                 }
                 else{
                     massratio = p->m/com.m;
                 }
-                for(int j=0; j < i + back_reactions_inclusive; j++){    // stop at j=i if inclusive, at i-1 if not
-                    rebx_subtract_posvel(&sim->particles[j], &diff, massratio);
-                }
+                rebx_subtract_posvel(&shift, &diff, -massratio);
                 break;
             case REBX_COORDINATES_PARTICLE:
                 if(back_reactions_inclusive){
@@ -235,9 +261,17 @@ void rebx_tools_com_ptm(struct reb_simulation* const sim, struct rebx_operator*
                 rebx_subtract_posvel(&sim->particles[refindex], &diff, massratio);
                 break;
             default:
-                reb_simulation_error(sim, "Coordinates not supported in REBOUNDx.\n");
+                rebx_error(sim->extras, "Coordinates not supported in REBOUNDx.\n");
         }
     }
+    if (coordinates == REBX_COORDINATES_BARYCENTRIC){
+        for(int j=0; j < N_real; j++){
+            rebx_subtract_posvel(&sim->particles[j], &shift, 1.);
+        }
+    }
+    else if (coordinates == REBX_COORDINATES_JACOBI){
+        rebx_subtract_posvel(&sim->particles[0], &shift, 1.);  // skipped in the loop
+    }
 }
 
 struct reb_vec3d rebx_tools_spin_angular_momentum(struct rebx_extras* const rebx){
@@ -245,10 +279,12 @@ struct reb_vec3d rebx_tools_spin_angular_momentum(struct rebx_extras* const rebx
     // Add spin angular momentum of any particles with spin parameters set
     const int N_real = sim->N - sim->N_var;
     struct reb_vec3d L = {0.};
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
+    const int I_key = rebx_get_param_key(rebx, "I");
     for (int i=0;i<N_real;i++){
 		struct reb_particle* pi = &sim->particles[i];
-        const struct reb_vec3d* Omega = rebx_get_param(rebx, pi->ap, "Omega");
-        const double* I = rebx_get_param(rebx, pi->ap, "I");
+        const struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, pi->ap, Omega_key);
+        const double* I = rebx_get_param_by_key(rebx, pi->ap, I_key);
 
         if (Omega != NULL && I != NULL){
           L.x += (*I) * (Omega->x);
@@ -264,10 +300,12 @@ double rebx_tools_spin_energy(struct rebx_extras* const rebx){
     // Add spin energy of any particles with spin parameters set
     const int N_real = sim->N - sim->N_var;
     double E = 0;
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
+    const int I_key = rebx_get_param_key(rebx, "I");
     for (int i=0;i<N_real;i++){
 		struct reb_particle* pi = &sim->particles[i];
-        const struct reb_vec3d* Omega = rebx_get_param(rebx, pi->ap, "Omega");
-        const double* I = rebx_get_param(rebx, pi->ap, "I");
+        const struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, pi->ap, Omega_key);
+        const double* I = rebx_get_param_by_key(rebx, pi->ap, I_key);
 
         if (Omega != NULL && I != NULL){
           E += 0.5 * (*I) * ((Omega->x) * (Omega->x) + (Omega->y) * (Omega->y) + (Omega->z) * (Omega->z));
@@ -280,10 +318,11 @@ void rebx_simulation_irotate(struct rebx_extras* const rebx, const struct reb_ro
     // Modified from celmech nbody_simulation_utilities.py to include spin angular momentum
     struct reb_simulation* const sim = rebx->sim;
     reb_simulation_irotate(sim, q); // rotate all the orbits first
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
     for (int i=0; i<sim->N; i++){
         struct reb_particle* p = &sim->particles[i];
         // Rotate spins
-        struct reb_vec3d* Omega = rebx_get_param(rebx, p->ap, "Omega");
+        struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, p->ap, Omega_key);
         if (Omega != NULL){
             reb_vec3d_irotate(Omega, q);
         }
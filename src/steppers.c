@@ -50,6 +50,7 @@
 #include <math.h>
 #include "rebound.h"
 #include "reboundx.h"
+#include "core.h"
 
 // will do IAS with gravity + any additional_forces
 
@@ -91,7 +92,9 @@ void rebx_jump_step(struct reb_simulation* const sim, struct rebx_operator* cons
 void rebx_interaction_step(struct reb_simulation* const sim, struct rebx_operator* const operator, const double dt){
     reb_integrator_whfast_init(sim);
     reb_integrator_whfast_from_inertial(sim);
+    rebx_set_whfast_jacobi_current(sim->extras, 1);    // forces like gr can read the Jacobi coordinates instead of recalculating them
     reb_simulation_update_acceleration(sim);
+    rebx_set_whfast_jacobi_current(sim->extras, 0);
     reb_whfast_interaction_step(sim, dt);
     reb_integrator_whfast_to_inertial(sim);
 }
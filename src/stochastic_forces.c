@@ -74,22 +74,43 @@ static void rebx_random_normal2(struct reb_simulation* r, double* n0, double* n1
 }
 
 
-void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force* const radiation_forces, struct reb_particle* const particles, const int N){
+void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* const particles, const int N){
     struct rebx_extras* const rebx = sim->extras;
     struct reb_particle com = particles[0];
+    const int kappa_key = rebx_get_param_key(rebx, "kappa");
+    const int stochastic_force_r_key = rebx_get_param_key(rebx, "stochastic_force_r");
+    const int stochastic_force_phi_key = rebx_get_param_key(rebx, "stochastic_force_phi");
+    const int tau_kappa_key = rebx_get_param_key(rebx, "tau_kappa");
+    const int kappa_x_key = rebx_get_param_key(rebx, "kappa_x");
+    const int stochastic_force_x_key = rebx_get_param_key(rebx, "stochastic_force_x");
+    const int tau_kappa_x_key = rebx_get_param_key(rebx, "tau_kappa_x");
+    const int kappa_y_key = rebx_get_param_key(rebx, "kappa_y");
+    const int stochastic_force_y_key = rebx_get_param_key(rebx, "stochastic_force_y");
+    const int tau_kappa_y_key = rebx_get_param_key(rebx, "tau_kappa_y");
+    const int kappa_z_key = rebx_get_param_key(rebx, "kappa_z");
+    const int stochastic_force_z_key = rebx_get_param_key(rebx, "stochastic_force_z");
+    const int tau_kappa_z_key = rebx_get_param_key(rebx, "tau_kappa_z");
+    const int keys[] = {kappa_key, stochastic_force_r_key, stochastic_force_phi_key, tau_kappa_key, kappa_x_key, stochastic_force_x_key, tau_kappa_x_key, kappa_y_key, stochastic_force_y_key, tau_kappa_y_key, kappa_z_key, stochastic_force_z_key, tau_kappa_z_key};
+    const int N_keys = sizeof(keys)/sizeof(keys[0]);
+    const struct rebx_participants* const participants = rebx_get_participants(rebx, force, particles, N, N_keys, keys);
+    if (participants == NULL){
+        return;
+    }
     
-    for (int i=0; i<N; i++){
-        double* kappa = rebx_get_param(rebx, particles[i].ap, "kappa");
+    for (int j=0; j<participants->N; j++){
+        const int i = participants->indices[j];
+        void* const* const values = &participants->values[j*N_keys];
+        double* kappa = values[0];
         if (i>0 && kappa != NULL){
-            double* stochastic_force_r = rebx_get_param(rebx, particles[i].ap, "stochastic_force_r");
+            double* stochastic_force_r = values[1];
             if (stochastic_force_r == NULL) { // First run?
-                rebx_set_param_double(rebx, (struct rebx_node**)&particles[i].ap, "stochastic_force_r", 0.);
-                stochastic_force_r = rebx_get_param(rebx, particles[i].ap, "stochastic_force_r");
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&particles[i].ap, stochastic_force_r_key, 0.);
+                stochastic_force_r = rebx_get_param_by_key(rebx, particles[i].ap, stochastic_force_r_key);
             }
-            double* stochastic_force_phi = rebx_get_param(rebx, particles[i].ap, "stochastic_force_phi");
+            double* stochastic_force_phi = values[2];
             if (stochastic_force_phi == NULL) { // First run?
-                rebx_set_param_double(rebx, (struct rebx_node**)&particles[i].ap, "stochastic_force_phi", 0.);
-                stochastic_force_phi = rebx_get_param(rebx, particles[i].ap, "stochastic_force_phi");
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&particles[i].ap, stochastic_force_phi_key, 0.);
+                stochastic_force_phi = rebx_get_param_by_key(rebx, particles[i].ap, stochastic_force_phi_key);
             }
 
             const struct reb_particle p = particles[i];
@@ -103,7 +124,7 @@ void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force*
             }
             double tau = o.P; // Default is current orbital period.
             
-            double* tau_kappa = rebx_get_param(rebx, particles[i].ap, "tau_kappa");
+            double* tau_kappa = values[3];
             if (tau_kappa != NULL){
                 tau *= *tau_kappa;
             }
@@ -148,15 +169,15 @@ void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force*
 
 		    com = reb_particle_com_of_pair(com, p);
         }
-        double* kappa_x = rebx_get_param(rebx, particles[i].ap, "kappa_x");
+        double* kappa_x = values[4];
         if (kappa_x != NULL){
-            double* stochastic_force_x = rebx_get_param(rebx, particles[i].ap, "stochastic_force_x");
+            double* stochastic_force_x = values[5];
             if (stochastic_force_x == NULL) { // First run?
-                rebx_set_param_double(rebx, (struct rebx_node**)&particles[i].ap, "stochastic_force_x", 0.);
-                stochastic_force_x = rebx_get_param(rebx, particles[i].ap, "stochastic_force_x");
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&particles[i].ap, stochastic_force_x_key, 0.);
+                stochastic_force_x = rebx_get_param_by_key(rebx, particles[i].ap, stochastic_force_x_key);
             }
             
-            double* tau_kappa_x = rebx_get_param(rebx, particles[i].ap, "tau_kappa_x");
+            double* tau_kappa_x = values[6];
             if (tau_kappa_x == NULL){
                 reb_simulation_error(sim, "Need to set tau_kappa_x to enable stochastic forces.\n");
                 return;
@@ -181,15 +202,15 @@ void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force*
             
             particles[i].ax += *stochastic_force_x;
         }
-        double* kappa_y = rebx_get_param(rebx, particles[i].ap, "kappa_y");
+        double* kappa_y = values[7];
         if (kappa_y != NULL){
-            double* stochastic_force_y = rebx_get_param(rebx, particles[i].ap, "stochastic_force_y");
+            double* stochastic_force_y = values[8];
             if (stochastic_force_y == NULL) { // First run?
-                rebx_set_param_double(rebx, (struct rebx_node**)&particles[i].ap, "stochastic_force_y", 0.);
-                stochastic_force_y = rebx_get_param(rebx, particles[i].ap, "stochastic_force_y");
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&particles[i].ap, stochastic_force_y_key, 0.);
+                stochastic_force_y = rebx_get_param_by_key(rebx, particles[i].ap, stochastic_force_y_key);
             }
             
-            double* tau_kappa_y = rebx_get_param(rebx, particles[i].ap, "tau_kappa_y");
+            double* tau_kappa_y = values[9];
             if (tau_kappa_y == NULL){
                 reb_simulation_error(sim, "Need to set tau_kappa_y to enable stochastic forces.\n");
                 return;
@@ -214,15 +235,15 @@ void rebx_stochastic_forces(struct reb_simulation* const sim, struct rebx_force*
             
             particles[i].ay += *stochastic_force_y;
         }
-        double* kappa_z = rebx_get_param(rebx, particles[i].ap, "kappa_z");
+        double* kappa_z = values[10];
         if (kappa_z != NULL){
-            double* stochastic_force_z = rebx_get_param(rebx, particles[i].ap, "stochastic_force_z");
+            double* stochastic_force_z = values[11];
             if (stochastic_force_z == NULL) { // First run?
-                rebx_set_param_double(rebx, (struct rebx_node**)&particles[i].ap, "stochastic_force_z", 0.);
-                stochastic_force_z = rebx_get_param(rebx, particles[i].ap, "stochastic_force_z");
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&particles[i].ap, stochastic_force_z_key, 0.);
+                stochastic_force_z = rebx_get_param_by_key(rebx, particles[i].ap, stochastic_force_z_key);
             }
             
-            double* tau_kappa_z = rebx_get_param(rebx, particles[i].ap, "tau_kappa_z");
+            double* tau_kappa_z = values[12];
             if (tau_kappa_z == NULL){
                 reb_simulation_error(sim, "Need to set tau_kappa_z to enable stochastic forces.\n");
                 return;
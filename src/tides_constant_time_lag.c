@@ -125,15 +125,18 @@ void rebx_tides_constant_time_lag(struct reb_simulation* const sim, struct rebx_
     if (target->m == 0){                        // nothing makes sense if primary has no mass
         return;
     }
-    double* k2 = rebx_get_param(rebx, target->ap, "tctl_k2");
+    const int k2_key = rebx_get_param_key(rebx, "tctl_k2");
+    const int tau_key = rebx_get_param_key(rebx, "tctl_tau");
+    const int Omega_key = rebx_get_param_key(rebx, "OmegaMag");
+    double* k2 = rebx_get_param_by_key(rebx, target->ap, k2_key);
     if (k2 != NULL && target->r != 0){  // tides on star only nonzero if k2 and finite size are set
         // We don't require time lag tau to be set. Might just want conservative piece of tidal potential
         double tau = 0.;
         double Omega = 0.;
-        double* tauptr = rebx_get_param(rebx, target->ap, "tctl_tau");
+        double* tauptr = rebx_get_param_by_key(rebx, target->ap, tau_key);
         if (tauptr){
             tau = *tauptr;
-            double* Omegaptr = rebx_get_param(rebx, target->ap, "OmegaMag");
+            double* Omegaptr = rebx_get_param_by_key(rebx, target->ap, Omega_key);
             if (Omegaptr){
                 Omega = *Omegaptr;
             }
@@ -151,16 +154,16 @@ void rebx_tides_constant_time_lag(struct reb_simulation* const sim, struct rebx_
     struct reb_particle* source = &particles[0]; // Source is always the star (no planet-planet tides)
     for (int i=1; i<N; i++){
         struct reb_particle* target = &particles[i]; 
-        double* k2 = rebx_get_param(rebx, target->ap, "tctl_k2");
+        double* k2 = rebx_get_param_by_key(rebx, target->ap, k2_key);
         if (k2 == NULL || target->r == 0 || target->m == 0){
             continue;
         }
         double tau = 0.;
         double Omega = 0.;
-        double* tauptr = rebx_get_param(rebx, target->ap, "tctl_tau");
+        double* tauptr = rebx_get_param_by_key(rebx, target->ap, tau_key);
         if (tauptr){
             tau = *tauptr;
-            double* Omegaptr = rebx_get_param(rebx, target->ap, "OmegaMag");
+            double* Omegaptr = rebx_get_param_by_key(rebx, target->ap, Omega_key);
             if (Omegaptr){
                 Omega = *Omegaptr;
             }
@@ -202,7 +205,8 @@ double rebx_tides_constant_time_lag_potential(struct rebx_extras* const rebx){
     if (target->m == 0){                        // No potential with massless primary
         return 0.;
     }
-    double* k2 = rebx_get_param(rebx, target->ap, "tctl_k2");
+    const int k2_key = rebx_get_param_key(rebx, "tctl_k2");
+    double* k2 = rebx_get_param_by_key(rebx, target->ap, k2_key);
     if (k2 != NULL && target->r != 0){  // tides on star only nonzero if k2 and finite size are set
         for (int i=1; i<N_real; i++){
             struct reb_particle* source = &particles[i]; // planet raising the tides on the star
@@ -217,7 +221,7 @@ double rebx_tides_constant_time_lag_potential(struct rebx_extras* const rebx){
     struct reb_particle* source = &particles[0]; // Source is always the star (no planet-planet tides)
     for (int i=1; i<N_real; i++){
         struct reb_particle* target = &particles[i]; 
-        double* k2 = rebx_get_param(rebx, target->ap, "tctl_k2");
+        double* k2 = rebx_get_param_by_key(rebx, target->ap, k2_key);
         if (k2 == NULL || target->r == 0 || target->m == 0){
             continue;
         }
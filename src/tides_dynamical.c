@@ -72,7 +72,7 @@
 #include "reboundx.h"
 #include "rebxtools.h"
 
-static struct rebx_tides_dynamical_params rebx_calculate_tides_dynamical_params(struct reb_simulation* const sim, struct reb_particle* p, struct reb_particle* primary, int raise)
+static struct rebx_tides_dynamical_params rebx_calculate_tides_dynamical_params(struct reb_simulation* const sim, struct reb_particle* p, struct reb_particle* primary, int raise, const int EB0_key, const int c_real_key, const int c_imag_key)
 {
 
     struct rebx_extras* const rebx = sim->extras;
@@ -130,9 +130,9 @@ static struct rebx_tides_dynamical_params rebx_calculate_tides_dynamical_params(
     double dE_alpha = sim->G * primary->m * primary->m * pow(R, 5) * T / pow(R_p, 6);
 
     // Calculate dP
-    double* EB0 = rebx_get_param(rebx, p->ap, "td_EB0");
-    double* c_real = rebx_get_param(rebx, p->ap, "td_c_real"); 
-    double* c_imag = rebx_get_param(rebx, p->ap, "td_c_imag");
+    double* EB0 = rebx_get_param_by_key(rebx, p->ap, EB0_key);
+    double* c_real = rebx_get_param_by_key(rebx, p->ap, c_real_key); 
+    double* c_imag = rebx_get_param_by_key(rebx, p->ap, c_imag_key);
     double maxE = dE_alpha + 2 * pow(-dE_alpha * (pow(*c_real, 2) + pow(*c_imag, 2)) * *EB0, 0.5);
     double EBk = -sim->G * p->m * primary->m / (2 * a);
     double dP = 1.5 * sigma * P * maxE / (-EBk);
@@ -192,91 +192,104 @@ void rebx_tides_dynamical(struct reb_simulation* const sim, struct rebx_force* c
         raise = *raiseptr;
     }
 
-    if (rebx_get_param(rebx, p->ap, "td_EB0") == NULL)
+    const int EB0_key = rebx_get_param_key(rebx, "td_EB0");
+    const int num_apoapsis_key = rebx_get_param_key(rebx, "td_num_apoapsis");
+    const int c_real_key = rebx_get_param_key(rebx, "td_c_real");
+    const int c_imag_key = rebx_get_param_key(rebx, "td_c_imag");
+    const int dP_crit_key = rebx_get_param_key(rebx, "td_dP_crit");
+    const int E_max_key = rebx_get_param_key(rebx, "td_E_max");
+    const int E_resid_key = rebx_get_param_key(rebx, "td_E_resid");
+    const int dP_hat_key = rebx_get_param_key(rebx, "td_dP_hat");
+    const int dE_last_key = rebx_get_param_key(rebx, "td_dE_last");
+    const int drag_coef_key = rebx_get_param_key(rebx, "td_drag_coef");
+    const int last_apoapsis_key = rebx_get_param_key(rebx, "td_last_apoapsis");
+    const int M_last_key = rebx_get_param_key(rebx, "td_M_last");
+
+    if (rebx_get_param_by_key(rebx, p->ap, EB0_key) == NULL)
     {
         double EB0 = -sim->G * p->m * source->m / (2 * o.a);
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_EB0", EB0);    
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, EB0_key, EB0);    
     }
-    if (rebx_get_param(rebx, p->ap, "td_num_apoapsis") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, num_apoapsis_key) == NULL)
     {
-        rebx_set_param_int(rebx, (struct rebx_node**)&p->ap, "td_num_apoapsis", 0);    
+        rebx_set_param_int_by_key(rebx, (struct rebx_node**)&p->ap, num_apoapsis_key, 0);    
     }
-    if (rebx_get_param(rebx, p->ap, "td_c_real") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, c_real_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_c_real", 0);   
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, c_real_key, 0);   
     }
-    if (rebx_get_param(rebx, p->ap, "td_c_imag") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, c_imag_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_c_imag", 0);    
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, c_imag_key, 0);    
     }
-    if (rebx_get_param(rebx, p->ap, "td_dP_crit") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, dP_crit_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_dP_crit", 0.01);    
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, dP_crit_key, 0.01);    
     }
-    if (rebx_get_param(rebx, p->ap, "td_E_max") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, E_max_key) == NULL)
     {
         double E_bind = sim->G * p->m * p->m / p->r;
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_E_max", E_bind / 10); 
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, E_max_key, E_bind / 10); 
     }
-    if (rebx_get_param(rebx, p->ap, "td_E_resid") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, E_resid_key) == NULL)
     {
         double E_bind = sim->G * p->m * p->m / p->r;
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_E_resid", E_bind / 1000);   
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, E_resid_key, E_bind / 1000);   
     }
-    if (rebx_get_param(rebx, p->ap, "td_dP_hat") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, dP_hat_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_dP_hat", 0);
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, dP_hat_key, 0);
     }
-    if (rebx_get_param(rebx, p->ap, "td_drag_coef") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, drag_coef_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_drag_coef", 0);
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, drag_coef_key, 0);
     }
-    if (rebx_get_param(rebx, p->ap, "td_last_apoapsis") == NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, last_apoapsis_key) == NULL)
     {
-        rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_last_apoapsis", 0);
+        rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, last_apoapsis_key, 0);
     }
 
     double n = 10;
 
-    if (rebx_get_param(rebx, p->ap, "td_M_last") != NULL)
+    if (rebx_get_param_by_key(rebx, p->ap, M_last_key) != NULL)
     {       
-        double* M_last = rebx_get_param(rebx, p->ap, "td_M_last");
+        double* M_last = rebx_get_param_by_key(rebx, p->ap, M_last_key);
         double drag = 0;
-        double* last_apoapsis_time = rebx_get_param(rebx, p->ap, "td_last_apoapsis");
+        double* last_apoapsis_time = rebx_get_param_by_key(rebx, p->ap, last_apoapsis_key);
         if ((o.M >= M_PI && *M_last < M_PI) && o.M - M_PI <= 1 && sim->t - *last_apoapsis_time >= sim->dt)
         { 
             // Count apoapsis passages
-            int* num_apoapsis = rebx_get_param(rebx, p->ap, "td_num_apoapsis");
-            rebx_set_param_int(rebx, (struct rebx_node**)&p->ap, "td_num_apoapsis", *num_apoapsis + 1);
+            int* num_apoapsis = rebx_get_param_by_key(rebx, p->ap, num_apoapsis_key);
+            rebx_set_param_int_by_key(rebx, (struct rebx_node**)&p->ap, num_apoapsis_key, *num_apoapsis + 1);
 
-            double* dP_crit = rebx_get_param(rebx, p->ap, "td_dP_crit");
-            struct rebx_tides_dynamical_params dynamical_params = rebx_calculate_tides_dynamical_params(sim, p, source, raise);
+            double* dP_crit = rebx_get_param_by_key(rebx, p->ap, dP_crit_key);
+            struct rebx_tides_dynamical_params dynamical_params = rebx_calculate_tides_dynamical_params(sim, p, source, raise, EB0_key, c_real_key, c_imag_key);
             double dP = dynamical_params.dP;
             double dE_alpha = dynamical_params.dE_alpha;
             
-            rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_dP_hat", dP);
-            rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_dE_last", dE_alpha);
+            rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, dP_hat_key, dP);
+            rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, dE_last_key, dE_alpha);
 
             // If system is in chaotic regime, evolve dynamical tides
             if (dP >= *dP_crit)
             {
                 // Calculate map parameters
-                double* EB0 = rebx_get_param(rebx, p->ap, "td_EB0");
+                double* EB0 = rebx_get_param_by_key(rebx, p->ap, EB0_key);
                 // double EBk = -sim->G * p->m * source->m / (2 * o.a);
                 double dc_tilde = pow(dE_alpha / -*EB0, 0.5);
                 // double dE_alpha_tilde = dE_alpha / -*EB0;
-                double* c_real = rebx_get_param(rebx, p->ap, "td_c_real"); 
-                double* c_imag = rebx_get_param(rebx, p->ap, "td_c_imag");
+                double* c_real = rebx_get_param_by_key(rebx, p->ap, c_real_key); 
+                double* c_imag = rebx_get_param_by_key(rebx, p->ap, c_imag_key);
 
                 // Evolve modes
                 double sigma = dynamical_params.sigma;
                 struct rebx_tides_dynamical_mode new_modes = rebx_calculate_tides_dynamical_mode_evolution(*c_real, *c_imag, dc_tilde, o.P, sigma);
                 double dEb = (-*EB0) * (new_modes.real*new_modes.real + new_modes.imag*new_modes.imag - *c_real* *c_real - *c_imag * *c_imag);
-                // double* EB_last = rebx_get_param(rebx, p->ap, "td_debug_Eb_last");
+                // double* EB_last = rebx_get_param_by_key(rebx, p->ap, debug_Eb_last_key);
 
                 // If mode energy is too high, non-linear dissipation
-                double* E_max = rebx_get_param(rebx, p->ap, "td_E_max"); 
-                double* E_resid = rebx_get_param(rebx, p->ap, "td_E_resid");
+                double* E_max = rebx_get_param_by_key(rebx, p->ap, E_max_key); 
+                double* E_resid = rebx_get_param_by_key(rebx, p->ap, E_resid_key);
                 if (-(pow(new_modes.real, 2) + pow(new_modes.imag, 2)) * *EB0 >= *E_max)
                 {
                     // re-scale modes so that E_mode = E_resid
@@ -285,21 +298,21 @@ void rebx_tides_dynamical(struct reb_simulation* const sim, struct rebx_force* c
                     new_modes.imag = pow(E_dis_ratio / (1 + pow(new_modes.real, 2) / pow(new_modes.imag, 2)), 0.5);
                 }
 
-                rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_c_real", new_modes.real);
-                rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_c_imag", new_modes.imag);  
-                rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_last_apoapsis", sim->t);
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, c_real_key, new_modes.real);
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, c_imag_key, new_modes.imag);  
+                rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, last_apoapsis_key, sim->t);
 
                 // Compute drag parameter
                 double I = rebx_calculate_tides_dynamical_drag_integral(sim, o.e, n);
                 drag = dEb * pow((o.a) * (1 - o.e * o.e), n - 0.5) / (2 * pow(sim->G * (p->m + source->m), 0.5) * I);
             }
-            rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_drag_coef", drag);
+            rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, drag_coef_key, drag);
         }
     }
 
-    rebx_set_param_double(rebx, (struct rebx_node**)&p->ap, "td_M_last", o.M);    
+    rebx_set_param_double_by_key(rebx, (struct rebx_node**)&p->ap, M_last_key, o.M);    
 
-    double* drag_coef = rebx_get_param(rebx, p->ap, "td_drag_coef");
+    double* drag_coef = rebx_get_param_by_key(rebx, p->ap, drag_coef_key);
 
     // Compute CoM
     double comx = 0;
@@ -146,7 +146,7 @@ struct reb_vec3d rebx_calculate_spin_orbit_accelerations(struct reb_particle* so
   return tot_force;
 }
 
-static void rebx_spin_orbit_accelerations(struct reb_particle* source, struct reb_particle* target, const double G, const double k2, const double sigma, const struct reb_vec3d Omega){
+static void rebx_spin_orbit_accelerations(struct reb_particle* source, struct reb_particle* target, const double G, const double k2, const double sigma, const struct reb_vec3d Omega, double* const acc_source){
 
     // Input params all associated with source
     const double ms = source->m;
@@ -160,9 +160,10 @@ static void rebx_spin_orbit_accelerations(struct reb_particle* source, struct re
     target->ay -= ((ms / mtot) * tot_force.y);
     target->az -= ((ms / mtot) * tot_force.z);
 
-    source->ax += ((mt / mtot) * tot_force.x);
-    source->ay += ((mt / mtot) * tot_force.y);
-    source->az += ((mt / mtot) * tot_force.z);
+    // back-reaction goes to the calling thread's buffer (see rebx_tides_spin)
+    acc_source[0] += ((mt / mtot) * tot_force.x);
+    acc_source[1] += ((mt / mtot) * tot_force.y);
+    acc_source[2] += ((mt / mtot) * tot_force.z);
 
 }
 
@@ -171,11 +172,14 @@ static void rebx_spin_derivatives(struct reb_ode* const ode, double* const yDot,
     struct rebx_extras* const rebx = sim->extras;
     unsigned int Nspins = 0;
     const int N_real = sim->N - sim->N_var;
+    const int k2_key = rebx_get_param_key(rebx, "k2");
+    const int tau_key = rebx_get_param_key(rebx, "tau");
+    const int I_key = rebx_get_param_key(rebx, "I");
     for (int i=0; i<N_real; i++){
         struct reb_particle* pi = &sim->particles[i]; // target particle
-        const double* k2 = rebx_get_param(rebx, pi->ap, "k2"); // This is slow
-        const double* tau = rebx_get_param(rebx, pi->ap, "tau");
-        const double* I = rebx_get_param(rebx, pi->ap, "I");
+        const double* k2 = rebx_get_param_by_key(rebx, pi->ap, k2_key);
+        const double* tau = rebx_get_param_by_key(rebx, pi->ap, tau_key);
+        const double* I = rebx_get_param_by_key(rebx, pi->ap, I_key);
 
         // Particle MUST have k2 and moment of inertia to feel effects
         if (k2 != NULL && I != NULL){
@@ -239,12 +243,13 @@ static void rebx_spin_sync_pre(struct reb_ode* const ode, const double* const y0
     struct rebx_extras* const rebx = sim->extras;
     unsigned int Nspins = 0;
     const int N_real = sim->N - sim->N_var;
+    const int I_key = rebx_get_param_key(rebx, "I");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
     for (int i=0; i<N_real; i++){
         struct reb_particle* p = &sim->particles[i];
-        double* I = rebx_get_param(rebx, p->ap, "I");
-        struct reb_vec3d* Omega = rebx_get_param(rebx, p->ap, "Omega");
+        double* I = rebx_get_param_by_key(rebx, p->ap, I_key);
+        struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, p->ap, Omega_key);
         if (I != NULL && Omega != NULL){
-            const struct reb_vec3d* Omega = rebx_get_param(rebx, p->ap, "Omega");
             ode->y[3*Nspins] = Omega->x;
             ode->y[3*Nspins+1] = Omega->y;
             ode->y[3*Nspins+2] = Omega->z;
@@ -263,12 +268,14 @@ static void rebx_spin_sync_post(struct reb_ode* const ode, const double* const y
     struct rebx_extras* const rebx = sim->extras;
     unsigned int Nspins = 0;
     const int N_real = sim->N - sim->N_var;
+    const int I_key = rebx_get_param_key(rebx, "I");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
     for (int i=0; i<N_real; i++){
         struct reb_particle* p = &sim->particles[i];
-        double* I = rebx_get_param(rebx, p->ap, "I");
-        struct reb_vec3d* Omega = rebx_get_param(rebx, p->ap, "Omega");
+        double* I = rebx_get_param_by_key(rebx, p->ap, I_key);
+        struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, p->ap, Omega_key);
         if (I != NULL && Omega != NULL){
-            rebx_set_param_vec3d(rebx, (struct rebx_node**)&p->ap, "Omega", (struct reb_vec3d){.x=y0[3*Nspins], .y=y0[3*Nspins+1], .z=y0[3*Nspins+2]});
+            *Omega = (struct reb_vec3d){.x=y0[3*Nspins], .y=y0[3*Nspins+1], .z=y0[3*Nspins+2]};
             Nspins += 1;
         }
     }
@@ -317,15 +324,18 @@ void rebx_tides_spin(struct reb_simulation* const sim, struct rebx_force* const
     // check if ODE is initialized
     struct reb_ode** ode = sim->odes;
     if (ode == NULL){
-      reb_simulation_warning(sim, "Spin axes are not being evolved. Call rebx_spin_initialize_ode to evolve\n");
+      rebx_warning(sim->extras, "Spin axes are not being evolved. Call rebx_spin_initialize_ode to evolve\n");
     }
 
+    const int k2_key = rebx_get_param_key(rebx, "k2");
+    const int tau_key = rebx_get_param_key(rebx, "tau");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
     for (int i=0; i<N; i++){
         struct reb_particle* source = &particles[i];
         // Particle must have a k2 set, otherwise we treat this body as a point particle
-        const double* k2 = rebx_get_param(rebx, source->ap, "k2");
-        const double* tau = rebx_get_param(rebx, source->ap, "tau");
-        const struct reb_vec3d* Omega = rebx_get_param(rebx, source->ap, "Omega");
+        const double* k2 = rebx_get_param_by_key(rebx, source->ap, k2_key);
+        const double* tau = rebx_get_param_by_key(rebx, source->ap, tau_key);
+        const struct reb_vec3d* Omega = rebx_get_param_by_key(rebx, source->ap, Omega_key);
 
         // Particle needs all three spin components and k2 to feel additional forces
         if (Omega != NULL && k2 != NULL){
@@ -335,7 +345,15 @@ void rebx_tides_spin(struct reb_simulation* const sim, struct rebx_force* const
             sigma_in = 4 * (*tau) * sim->G / (3. * source->r * source->r * source->r * source->r * source->r * (*k2));
           }
 
-          for (int j=0; j<N; j++){
+          struct rebx_acc_buffers* const buffers = rebx_get_acc_buffers(rebx, effect, 1, N);
+          if (buffers == NULL){
+              return;
+          }
+#pragma omp parallel for if(N >= REBX_OMP_MIN_N)
+          for (int b=0; b<buffers->N_blocks; b++){
+          int start, end;
+          double* const acc_source = rebx_block_acc(buffers, b, &start, &end);
+          for (int j=start; j<end; j++){
               if (i==j){
                   continue;
               }
@@ -344,8 +362,10 @@ void rebx_tides_spin(struct reb_simulation* const sim, struct rebx_force* const
                   continue;
               }
 
-              rebx_spin_orbit_accelerations(source, target, G, *k2, sigma_in, *Omega);
+              rebx_spin_orbit_accelerations(source, target, G, *k2, sigma_in, *Omega, acc_source);
+          }
           }
+          rebx_reduce_acc_buffers(buffers, particles, &i);
       }
     }
 }
@@ -385,12 +405,15 @@ double rebx_tides_spin_energy(struct rebx_extras* const rebx){
     struct reb_particle* const particles = sim->particles;
     const double G = sim->G;
     double E=0.;
+    const int k2_key = rebx_get_param_key(rebx, "k2");
+    const int Omega_key = rebx_get_param_key(rebx, "Omega");
+    const int I_key = rebx_get_param_key(rebx, "I");
 
     for (int i=0; i<N_real; i++){
         struct reb_particle* source = &particles[i];
         // Particle must have a k2, radius and mass set, otherwise we treat this body as a point particle
-        const double* k2 = rebx_get_param(rebx, source->ap, "k2");
-        const struct reb_vec3d* Omegaptr = rebx_get_param(rebx, source->ap, "Omega");
+        const double* k2 = rebx_get_param_by_key(rebx, source->ap, k2_key);
+        const struct reb_vec3d* Omegaptr = rebx_get_param_by_key(rebx, source->ap, Omega_key);
         if (k2 == NULL || source->m == 0 || source->r == 0){
             continue;
         }
@@ -398,7 +421,7 @@ double rebx_tides_spin_energy(struct rebx_extras* const rebx){
         if (Omegaptr != NULL){
             Omega = *Omegaptr;
         }
-        double* I = rebx_get_param(rebx, source->ap, "I");
+        double* I = rebx_get_param_by_key(rebx, source->ap, I_key);
         if (I != NULL){
             const double omega_squared = Omega.x * Omega.x + Omega.y * Omega.y + Omega.z * Omega.z;
             E += 0.5 * (*I) * omega_squared;
@@ -66,11 +66,14 @@
 void rebx_track_min_distance(struct reb_simulation* const sim, struct rebx_operator* const operator, const double dt){
     struct rebx_extras* const rebx = sim->extras;
     const int N = sim->N - sim->N_var;
+    const int min_distance_key = rebx_get_param_key(rebx, "min_distance");
+    const int min_distance_from_key = rebx_get_param_key(rebx, "min_distance_from");
+    const int min_distance_orbit_key = rebx_get_param_key(rebx, "min_distance_orbit");
     for(int i=0; i<N; i++){
         struct reb_particle* const p = &sim->particles[i];
-        double* min_distance = rebx_get_param(rebx, p->ap, "min_distance");
+        double* min_distance = rebx_get_param_by_key(rebx, p->ap, min_distance_key);
         if (min_distance != NULL){
-            const uint32_t* const target = rebx_get_param(rebx, p->ap, "min_distance_from");
+            const uint32_t* const target = rebx_get_param_by_key(rebx, p->ap, min_distance_from_key);
             struct reb_particle* source;
             if (target == NULL){
                 source = &sim->particles[0];
@@ -84,7 +87,7 @@ void rebx_track_min_distance(struct reb_simulation* const sim, struct rebx_opera
             const double r2 = dx*dx + dy*dy + dz*dz;
             if (r2 < *min_distance*(*min_distance)){
                 *min_distance = sqrt(r2);
-                struct reb_orbit* const orbit = rebx_get_param(rebx, p->ap, "min_distance_orbit");
+                struct reb_orbit* const orbit = rebx_get_param_by_key(rebx, p->ap, min_distance_orbit_key);
                 if (orbit != NULL){
                     *orbit = reb_orbit_from_particle(sim->G, *p, *source);
                 }
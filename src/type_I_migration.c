@@ -112,7 +112,17 @@ const double rebx_calculate_inclination_damping_timescale(const double wave, con
     return t_i;
 }
 
-static struct reb_vec3d rebx_calculate_modify_orbits_with_type_I_migration(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source){
+struct rebx_type_I_migration_keys{
+    int ide_position;
+    int ide_width;
+    int flaring_index;
+    int surface_density_exponent;
+    int surface_density_1;
+    int scale_height_1;
+};
+
+static struct reb_vec3d rebx_calculate_modify_orbits_with_type_I_migration(struct reb_simulation* const sim, struct rebx_force* const force, struct reb_particle* p, struct reb_particle* source, const void* const keys_ptr){
+    const struct rebx_type_I_migration_keys* const keys = keys_ptr;
     double invtau_mig;
     double tau_e;
     double tau_inc;
@@ -126,12 +136,12 @@ static struct reb_vec3d rebx_calculate_modify_orbits_with_type_I_migration(struc
     double hedge = 0.0;
 
     /* Parameters that should be changed/set in Python notebook or in C outside of this */
-    const double* const dedge_ptr = rebx_get_param(sim->extras, force->ap, "ide_position");
-    const double* const hedge_ptr = rebx_get_param(sim->extras, force->ap, "ide_width");
-    const double* const beta_ptr = rebx_get_param(sim->extras, force->ap, "tIm_flaring_index");
-    const double* const s_ptr = rebx_get_param(sim->extras, force->ap, "tIm_surface_density_exponent");
-    const double* const sd0_ptr = rebx_get_param(sim->extras, force->ap, "tIm_surface_density_1");
-    const double* const h0_ptr = rebx_get_param(sim->extras, force->ap, "tIm_scale_height_1");
+    const double* const dedge_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->ide_position);
+    const double* const hedge_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->ide_width);
+    const double* const beta_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->flaring_index);
+    const double* const s_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->surface_density_exponent);
+    const double* const sd0_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->surface_density_1);
+    const double* const h0_ptr = rebx_get_param_by_key(sim->extras, force->ap, keys->scale_height_1);
 
     /* Accessing the calculated semi-major axis, eccentricity and inclination for each integration step, via modify_orbits_direct where they are calculated and returned*/
     int err=0;
@@ -210,5 +220,13 @@ void rebx_modify_orbits_with_type_I_migration(struct reb_simulation* const sim,
     }
     const int back_reactions_inclusive = 1;
     const char* reference_name = "primary";
-    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_with_type_I_migration, particles, N);
+    const struct rebx_type_I_migration_keys keys = {
+        .ide_position = rebx_get_param_key(sim->extras, "ide_position"),
+        .ide_width = rebx_get_param_key(sim->extras, "ide_width"),
+        .flaring_index = rebx_get_param_key(sim->extras, "tIm_flaring_index"),
+        .surface_density_exponent = rebx_get_param_key(sim->extras, "tIm_surface_density_exponent"),
+        .surface_density_1 = rebx_get_param_key(sim->extras, "tIm_surface_density_1"),
+        .scale_height_1 = rebx_get_param_key(sim->extras, "tIm_scale_height_1"),
+    };
+    rebx_com_force(sim, force, coordinates, back_reactions_inclusive, reference_name, rebx_calculate_modify_orbits_with_type_I_migration, &keys, particles, N);
 }
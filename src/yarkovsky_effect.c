@@ -125,7 +125,7 @@ static void rebx_calculate_yarkovsky_effect(struct reb_simulation* sim, struct r
         
         //makes sure all necessary parameters have been entered
         if (stef_boltz == NULL || rotation_period == NULL || Gamma == NULL || albedo == NULL || emissivity == NULL || k == NULL || sx == NULL || sy == NULL || sz == NULL) {
-            reb_simulation_error(sim, "REBOUNDx Error: One or more parameters missing for this version of the Yarkovsky effect in Rebx. Please make sure you've given values to all variables for this version before running simulations. See documentation and YarkovskyEffect.ipynb. If you'd rather use the simplified version of this effect (requires fewer parameters), then please set 'yark_flag' to -1 or 1.\n\n");
+            rebx_error(sim->extras, "REBOUNDx Error: One or more parameters missing for this version of the Yarkovsky effect in Rebx. Please make sure you've given values to all variables for this version before running simulations. See documentation and YarkovskyEffect.ipynb. If you'd rather use the simplified version of this effect (requires fewer parameters), then please set 'yark_flag' to -1 or 1.\n\n");
             return;
         }
         
@@ -220,25 +220,36 @@ void rebx_yarkovsky_effect(struct reb_simulation* const sim, struct rebx_force*
     struct rebx_extras* const rebx = sim->extras;
     double G = sim->G;
     
+    double* lstar = rebx_get_param(rebx, force->ap, "ye_lstar");
+    double* c = rebx_get_param(rebx, force->ap, "ye_c");
+    double* stef_boltz = rebx_get_param(rebx, force->ap, "ye_stef_boltz");
+
+    const int density_key = rebx_get_param_key(rebx, "ye_body_density");
+    const int rotation_period_key = rebx_get_param_key(rebx, "ye_rotation_period");
+    const int Gamma_key = rebx_get_param_key(rebx, "ye_thermal_inertia");
+    const int albedo_key = rebx_get_param_key(rebx, "ye_albedo");
+    const int emissivity_key = rebx_get_param_key(rebx, "ye_emissivity");
+    const int k_key = rebx_get_param_key(rebx, "ye_k");
+    const int yark_flag_key = rebx_get_param_key(rebx, "ye_flag");
+    const int sx_key = rebx_get_param_key(rebx, "ye_spin_axis_x");
+    const int sy_key = rebx_get_param_key(rebx, "ye_spin_axis_y");
+    const int sz_key = rebx_get_param_key(rebx, "ye_spin_axis_z");
     
     for (int i=1; i<N; i++){
         
         struct reb_particle* target = &particles[i];
         struct reb_particle* star = &particles[0];
         
-        double* density = rebx_get_param(rebx, target->ap, "ye_body_density");
-        double* lstar = rebx_get_param(rebx, force->ap, "ye_lstar");
-        double* rotation_period = rebx_get_param(rebx, target->ap, "ye_rotation_period");
-        double* Gamma = rebx_get_param(rebx, target->ap, "ye_thermal_inertia");
-        double* albedo = rebx_get_param(rebx, target->ap, "ye_albedo");
-        double* emissivity = rebx_get_param(rebx, target->ap, "ye_emissivity");
-        double* k = rebx_get_param(rebx, target->ap, "ye_k");
-        double* c = rebx_get_param(rebx, force->ap, "ye_c");
-        double* stef_boltz = rebx_get_param(rebx, force->ap, "ye_stef_boltz");
-        int* yark_flag = rebx_get_param(rebx, target->ap, "ye_flag");
-        double* sx = rebx_get_param(rebx, target->ap, "ye_spin_axis_x");
-        double* sy = rebx_get_param(rebx, target->ap, "ye_spin_axis_y");
-        double* sz = rebx_get_param(rebx, target->ap, "ye_spin_axis_z");
+        double* density = rebx_get_param_by_key(rebx, target->ap, density_key);
+        double* rotation_period = rebx_get_param_by_key(rebx, target->ap, rotation_period_key);
+        double* Gamma = rebx_get_param_by_key(rebx, target->ap, Gamma_key);
+        double* albedo = rebx_get_param_by_key(rebx, target->ap, albedo_key);
+        double* emissivity = rebx_get_param_by_key(rebx, target->ap, emissivity_key);
+        double* k = rebx_get_param_by_key(rebx, target->ap, k_key);
+        int* yark_flag = rebx_get_param_by_key(rebx, target->ap, yark_flag_key);
+        double* sx = rebx_get_param_by_key(rebx, target->ap, sx_key);
+        double* sy = rebx_get_param_by_key(rebx, target->ap, sy_key);
+        double* sz = rebx_get_param_by_key(rebx, target->ap, sz_key);
         
         //if these necessary conditions are met the Yarkovsky effect will be calculated for a particle in the sim
         if (density != NULL && target->r != 0 && albedo != NULL && lstar != NULL && c != NULL && yark_flag != NULL){